@@ -0,0 +1,380 @@
+// ejson benchmarks
+//
+// build and run (from the repository root):
+//     clang++ -I . -std=c++20 -O2 -o benchmark.exe ./benchmark/ejson_benchmark.cpp
+//     ./benchmark.exe
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <sstream>
+
+#include <ejson/ejson.h>
+
+namespace benchmark
+{
+    using namespace ejson;
+
+    // run function until at least 0.5s elapsed, print best throughput in MB/s for size characters
+    void Run(const char* name, size_t size, const std::function<void()>& function)
+    {
+        using clock = std::chrono::steady_clock;
+        double best = 1e30;
+        double total = 0.0;
+        int iterations = 0;
+        while (total < 0.5 || iterations < 3)
+        {
+            clock::time_point start = clock::now();
+            function();
+            double seconds = std::chrono::duration<double>(clock::now() - start).count();
+            best = std::min(best, seconds);
+            total += seconds;
+            ++iterations;
+        }
+        double megabytes = (double)(size * sizeof(string_char)) / (1024.0 * 1024.0);
+        std::printf("%-32s %10.1f MB/s %10.3f ms\n", name, megabytes / best, best * 1000.0);
+    }
+
+    // listener doing nothing, measures the tokenizer alone
+    struct NullListener
+    {
+        void ObjectBegin() noexcept {}
+        void ObjectEnd() noexcept {}
+        void PropertyBegin(const string_view&) noexcept {}
+        void PropertyEnd() noexcept {}
+        void ArrayBegin() noexcept {}
+        void ArrayEnd() noexcept {}
+        void ValueBool(bool) noexcept {}
+        void ValueNull() noexcept {}
+        void ValueString(const string_view&) noexcept {}
+        void ValueNumber(const string_view&) noexcept {}
+    };
+
+    // skips every object, measures the raw skip over the records
+    struct SkipListener : NullListener
+    {
+        Listen ObjectBegin() noexcept { return Listen::Skip; }
+    };
+
+    void RunParse(const char* name, const string& json)
+    {
+        Run(name, StringSize(json), [&]()
+        {
+            NullListener listener;
+            StringReader stringReader(json);
+            JsonReader jsonReader(listener, stringReader);
+            if (!jsonReader.Parse())
+                std::printf("%s: parse error\n", name);
+        });
+    }
+
+    // stream input: the reader is refilled every few thousand characters
+    void RunParseStream(const char* name, const string& json)
+    {
+        Run(name, StringSize(json), [&]()
+        {
+            NullListener listener;
+            std::basic_istringstream<string_char> stream(json);
+            StreamReader streamReader(stream);
+            JsonReader jsonReader(listener, streamReader);
+            if (!jsonReader.Parse())
+                std::printf("%s: parse error\n", name);
+        });
+    }
+
+    void RunParseSkip(const char* name, const string& json)
+    {
+        Run(name, StringSize(json), [&]()
+        {
+            SkipListener listener;
+            StringReader stringReader(json);
+            JsonReader jsonReader(listener, stringReader);
+            if (!jsonReader.Parse())
+                std::printf("%s: parse error\n", name);
+        });
+    }
+
+    // pull every token, the cursor counterpart of RunParse
+    void RunParseCursor(const char* name, const string& json)
+    {
+        Run(name, StringSize(json), [&]()
+        {
+            StringReader stringReader(json);
+            JsonCursor cursor(stringReader);
+            CursorToken token = cursor.NextToken();
+            while (token != CursorToken::End && token != CursorToken::Error)
+                token = cursor.NextToken();
+            if (token == CursorToken::Error)
+                std::printf("%s: parse error\n", name);
+        });
+    }
+
+    void RunParseIndex(const char* name, const string& json)
+    {
+        Run(name, StringSize(json), [&]()
+        {
+            NullListener listener;
+            JsonIndexReader jsonReader(listener, json);
+            if (!jsonReader.Parse())
+                std::printf("%s: parse error\n", name);
+        });
+    }
+
+    void RunRead(const char* name, const string& json)
+    {
+        Run(name, StringSize(json), [&]()
+        {
+            Value value;
+            if (!Read(json, value))
+                std::printf("%s: parse error\n", name);
+        });
+    }
+
+#if EJSON_ARENA
+    // same document read again and again, the arena is reused
+    void RunReadDocument(const char* name, const string& json)
+    {
+        Document document;
+        Run(name, StringSize(json), [&]()
+        {
+            if (!document.Read(json))
+                std::printf("%s: parse error\n", name);
+        });
+    }
+#endif
+
+    void RunWrite(const char* name, const string& json)
+    {
+        Value value;
+        if (!Read(json, value))
+            std::printf("%s: parse error\n", name);
+        Run(name, StringSize(json), [&]()
+        {
+            string output;
+            Write(value, output);
+        });
+    }
+
+    // same through an output stream
+    void RunWriteStream(const char* name, const string& json)
+    {
+        Value value;
+        if (!Read(json, value))
+            std::printf("%s: parse error\n", name);
+        Run(name, StringSize(json), [&]()
+        {
+            std::basic_ostringstream<string_char> stream;
+            Write(value, stream, true);
+        });
+    }
+
+    // property lookups in every record of an array
+    void RunLookup(const char* name, const string& json, const vector<string>& keys)
+    {
+        Value value;
+        if (!Read(json, value))
+            std::printf("%s: parse error\n", name);
+        const Value& records = value;
+        Run(name, StringSize(json), [&]()
+        {
+            size_t found = 0;
+            for (const Value& record : records.AsArray())
+            {
+                for (const string& key : keys)
+                    found += record.AsObject().Find(key) != nullptr;
+            }
+            if (found == 0)
+                std::printf("%s: not found\n", name);
+        });
+    }
+
+    void RunReadPath(const char* name, const string& json, const PathFilter& filter)
+    {
+        Run(name, StringSize(json), [&]()
+        {
+            Value value;
+            if (!Read(json, filter, value))
+                std::printf("%s: parse error\n", name);
+        });
+    }
+
+    void RunReadParallel(const char* name, const string& json)
+    {
+        Run(name, StringSize(json), [&]()
+        {
+            Value value;
+            if (!ReadParallel(json, value))
+                std::printf("%s: parse error\n", name);
+        });
+    }
+
+    // one record per line, ReadLines with one worker then all hardware threads
+    void RunReadLines(const char* name, const string& json, u32 workers)
+    {
+        Run(name, StringSize(json), [&]()
+        {
+            LinesOptions options;
+            options.Workers = workers;
+            bool result = true;
+            ReadLines(json, [&](size_t, bool recordResult, Value&, const ParserError&) { result = result && recordResult; }, options);
+            if (!result)
+                std::printf("%s: parse error\n", name);
+        });
+    }
+
+    // array of objects with long log messages
+    string StringDocument()
+    {
+        string json = EJSON_TEXT("[");
+        for (int i = 0; i < 20000; ++i)
+        {
+            if (i != 0)
+                json += EJSON_TEXT(",");
+            json += EJSON_TEXT("{\"level\":\"info\",\"message\":\"");
+            for (int j = 0; j < 4 + i % 8; ++j)
+                json += EJSON_TEXT("request handled by worker pool without error, ");
+            json += EJSON_TEXT("done\"}");
+        }
+        json += EJSON_TEXT("]");
+        return json;
+    }
+
+    // prettified records, mostly indentation
+    string PrettyDocument()
+    {
+        string json = EJSON_TEXT("[\n");
+        for (int i = 0; i < 20000; ++i)
+        {
+            if (i != 0)
+                json += EJSON_TEXT(",\n");
+            json += EJSON_TEXT("        {\n                \"id\": 12,\n                \"name\": \"John\",\n                \"tags\": [\n                        true,\n                        null\n                ]\n        }");
+        }
+        json += EJSON_TEXT("\n]");
+        return json;
+    }
+
+    // log records, one per line
+    string LinesDocument()
+    {
+        string json;
+        for (int i = 0; i < 100000; ++i)
+            json += EJSON_TEXT("{\"level\":\"info\",\"id\":12,\"message\":\"request handled\",\"tags\":[true,null]}\n");
+        return json;
+    }
+
+    // GeoJSON like polygon rings, longitude/latitude pairs with 6 to 8 decimals
+    string CoordinateDocument()
+    {
+        string json = EJSON_TEXT("[");
+        u64 seed = 0x9E3779B97F4A7C15ull;
+        for (int i = 0; i < 100000; ++i)
+        {
+            if (i != 0)
+                json += EJSON_TEXT(",");
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            const double longitude = (double)(seed >> 11) / (double)(1ull << 53) * 360.0 - 180.0;
+            const double latitude = (double)((seed >> 7) % 1000000007) / 1000000007.0 * 180.0 - 90.0;
+            char text[64];
+            std::snprintf(text, sizeof(text), "[%.*f,%.*f]", 6 + i % 3, longitude, 6 + (i + 1) % 3, latitude);
+            json += string(text, text + std::strlen(text));
+        }
+        json += EJSON_TEXT("]");
+        return json;
+    }
+
+    string ToString(int value)
+    {
+        std::string digits = std::to_string(value);
+        return string(digits.begin(), digits.end());
+    }
+
+    // one million numbers in a flat array, the tree is mostly the values themselves
+    string NumberArrayDocument()
+    {
+        string json = EJSON_TEXT("[");
+        for (int i = 0; i < 1000000; ++i)
+        {
+            if (i != 0)
+                json += EJSON_TEXT(",");
+            json += ToString((int)((s64)i * 7919 % 1000003));
+        }
+        json += EJSON_TEXT("]");
+        return json;
+    }
+
+    // api records, a few short properties each
+    string RecordDocument()
+    {
+        string json = EJSON_TEXT("[");
+        for (int i = 0; i < 100000; ++i)
+        {
+            if (i != 0)
+                json += EJSON_TEXT(",");
+            json += EJSON_TEXT("{\"id\":") + ToString(i) + EJSON_TEXT(",\"type\":\"user\",\"name\":\"John\",\"active\":true,\"score\":") + ToString(i % 1000) + EJSON_TEXT(",\"parent\":null}");
+        }
+        json += EJSON_TEXT("]");
+        return json;
+    }
+
+    // compact records of numbers and literals, every character goes through the tokenizer
+    string NumberDocument()
+    {
+        string json = EJSON_TEXT("[");
+        for (int i = 0; i < 100000; ++i)
+        {
+            if (i != 0)
+                json += EJSON_TEXT(",");
+            json += EJSON_TEXT("[") + ToString(i * 7919 % 1000003) + EJSON_TEXT(",-") + ToString(i % 977) + EJSON_TEXT(".") + ToString(i % 89 + 10) + EJSON_TEXT(",true,null,") + ToString(i) + EJSON_TEXT("]");
+        }
+        json += EJSON_TEXT("]");
+        return json;
+    }
+}
+
+int main()
+{
+    using namespace benchmark;
+
+    const string strings = StringDocument();
+    const string prettified = PrettyDocument();
+    const string numbers = NumberDocument();
+    const string lines = LinesDocument();
+    const string coordinates = CoordinateDocument();
+    const string records = RecordDocument();
+    const string numberArray = NumberArrayDocument();
+
+    std::printf("%-32s %10zu bytes\n", "value size", sizeof(Value));
+
+    RunParse("parse strings", strings);
+    RunParse("parse prettified", prettified);
+    RunParse("parse numbers", numbers);
+    RunParseStream("parse stream prettified", prettified);
+    RunParseCursor("parse cursor strings", strings);
+    RunParseCursor("parse cursor prettified", prettified);
+    RunParseSkip("parse skip strings", strings);
+    RunParseSkip("parse skip prettified", prettified);
+    RunParseIndex("parse index strings", strings);
+    RunParseIndex("parse index prettified", prettified);
+    RunRead("read strings", strings);
+    RunRead("read prettified", prettified);
+    RunRead("read coordinates", coordinates);
+    RunRead("read records", records);
+    RunRead("read number array", numberArray);
+    RunLookup("lookup records", records, { EJSON_TEXT("id"), EJSON_TEXT("name"), EJSON_TEXT("score"), EJSON_TEXT("missing") });
+#if EJSON_ARENA
+    RunReadDocument("read document strings", strings);
+    RunReadDocument("read document prettified", prettified);
+    RunReadDocument("read document coordinates", coordinates);
+#endif
+    RunWrite("write numbers", numbers);
+    RunWrite("write coordinates", coordinates);
+    RunWrite("write records", records);
+    RunWriteStream("write stream prettified", prettified);
+    RunReadPath("read path prettified", prettified, { EJSON_TEXT("/100/name"), EJSON_TEXT("$[19999].tags") });
+    RunReadParallel("read parallel prettified", prettified);
+    RunReadLines("read lines", lines, 1);
+    RunReadLines("read lines parallel", lines, 0);
+
+    return 0;
+}
@@ -36,9 +36,13 @@
 
 // std default implementation
 
+#include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <map>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 #include <sstream>
 #include <unordered_map>
@@ -73,6 +77,21 @@
 // keep insertion/parsing order ? For serialization loading only when order don't matter, set this to 0 for speed
 #define EJSON_MAP_ORDERED 1
 
+// ordered objects up to this many properties are searched linearly without a hash index, 0 always indexes
+#ifndef EJSON_SMALL_OBJECT
+    #define EJSON_SMALL_OBJECT 8
+#endif
+
+// strings, arrays and objects allocate from the memory resource of the calling thread, set by ejson::ArenaScope
+// (heap otherwise): a Document keeps a whole tree in one arena. Containers are one pointer larger.
+#ifndef EJSON_ARENA
+    #define EJSON_ARENA 0
+#endif
+
+#if EJSON_ARENA
+    #include <memory_resource>
+#endif
+
 namespace ejson
 {
     // double or float
@@ -92,22 +111,62 @@ namespace ejson
     using f32 = std::float_t;
     using f64 = std::double_t;
 
-    using c_string = std::string;
+#if EJSON_ARENA
+    // memory resource of the calling thread, new/delete unless an ArenaScope is active
+    inline std::pmr::memory_resource*& ThreadResource() noexcept
+    {
+        thread_local std::pmr::memory_resource* resource = std::pmr::new_delete_resource();
+        return resource;
+    }
+
+    // a container takes the thread resource when it is created or copied, and keeps it when moved
+    template<typename T>
+    class Allocator : public std::pmr::polymorphic_allocator<T>
+    {
+    public:
+
+        Allocator() noexcept
+            : std::pmr::polymorphic_allocator<T>(ThreadResource())
+        {}
+
+        Allocator(std::pmr::memory_resource* resource) noexcept
+            : std::pmr::polymorphic_allocator<T>(resource)
+        {}
+
+        template<typename OTHER>
+        Allocator(const Allocator<OTHER>& other) noexcept
+            : std::pmr::polymorphic_allocator<T>(other.resource())
+        {}
+
+        Allocator select_on_container_copy_construction() const noexcept
+        {
+            return Allocator();
+        }
+    };
+
+    template<typename CHAR>
+    using basic_string = std::basic_string<CHAR, std::char_traits<CHAR>, Allocator<CHAR>>;
+#else
+    template<typename CHAR>
+    using basic_string = std::basic_string<CHAR>;
+#endif
+
+    using c_string = basic_string<char>;
     using c_string_view = std::string_view;
 
-    using w_string = std::wstring;
+    using w_string = basic_string<wchar_t>;
     using w_string_view = std::wstring_view;
 
 #if EJSON_WCHAR
     using string_char = wchar_t;
     using string_view = std::wstring_view;
-    using string = std::wstring;
+    using string = w_string;
     using input_stream = std::basic_istream<wchar_t>;
     using output_stream = std::basic_ostream<wchar_t>;
 #else
     using string_char = char;
     using string_view = std::string_view;
-    using string = std::string;
+    using string = c_string;
     using input_stream = std::basic_istream<char>;
     using output_stream = std::basic_ostream<char>;
 #endif
@@ -133,6 +192,11 @@ namespace ejson
         str.append(other);
     }
 
+    inline void StringAdd(string& str, const string_char* begin, const string_char* end) noexcept
+    {
+        str.append(begin, end);
+    }
+
     inline void StringConvert(const c_string_view& src, w_string& dst )
     {
         dst.clear();
@@ -152,20 +216,6 @@ namespace ejson
         }
     }
 
-    inline void WriteNumber(number value, string& output) noexcept
-    {
-        // todo: make our own function with no allocation
-#if EJSON_WCHAR
-        std::wstringstream wss;
-        wss << value;
-        output = wss.str();
-#else
-        std::stringstream wss;
-        wss << value;
-        output = wss.str();
-#endif
-    }
-
     // stream
 
     inline bool StreamWrite(output_stream& stream, string_char car) noexcept
@@ -176,14 +226,19 @@ namespace ejson
 
     inline size_t StreamWrite(output_stream& stream, const string_view& str) noexcept
     {
-        stream << str;
-        return StringSize(str);
+        stream.write(str.data(), (std::streamsize)str.size());
+        return stream.good() ? StringSize(str) : 0;
     }
 
     // vector
 
+#if EJSON_ARENA
+    template<typename VALUE>
+    using vector = std::vector<VALUE, Allocator<VALUE>>;
+#else
     template<typename VALUE>
     using vector = std::vector<VALUE>;
+#endif
 
     template<typename VALUE>
     size_t VectorSize(const vector<VALUE>& vector) noexcept
@@ -206,6 +261,122 @@ namespace ejson
 
 #if EJSON_MAP_ORDERED
 
+    // Immutable key shared by the maps that use it: copies share one node with a reference count and the hash,
+    // a key read in many objects is stored once (see KeyTable). Handles of one node compare by pointer.
+    template<typename KEY>
+    class SharedKey
+    {
+    public:
+
+        using CharType = typename KEY::value_type;
+
+        SharedKey() noexcept = default;
+
+        explicit SharedKey(const KEY& key) noexcept
+            : node(NewNode(key, Hash(key)))
+        {}
+
+        SharedKey(const KEY& key, size_t hash) noexcept
+            : node(NewNode(key, hash))
+        {}
+
+        SharedKey(const SharedKey& other) noexcept
+            : node(other.node)
+        {
+#if EJSON_ARENA
+            // a copy made under another resource must not point in the arena of the original
+            if (node != nullptr && node->Key.get_allocator().resource() != ThreadResource())
+            {
+                node = NewNode(other.node->Key, other.node->Hash);
+                return;
+            }
+#endif
+            if (node != nullptr)
+                node->References.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        SharedKey(SharedKey&& other) noexcept
+            : node(other.node)
+        {
+            other.node = nullptr;
+        }
+
+        SharedKey& operator=(SharedKey other) noexcept
+        {
+            std::swap(node, other.node);
+            return *this;
+        }
+
+        ~SharedKey() noexcept
+        {
+            if (node != nullptr && node->References.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                DeleteNode(node);
+        }
+
+        bool IsNull() const noexcept
+        {
+            return node == nullptr;
+        }
+
+        const KEY& Get() const noexcept
+        {
+            return node->Key;
+        }
+
+        size_t GetHash() const noexcept
+        {
+            return node->Hash;
+        }
+
+        bool operator==(const SharedKey& other) const noexcept
+        {
+            return node == other.node || (node->Hash == other.node->Hash && node->Key == other.node->Key);
+        }
+
+        static size_t Hash(std::basic_string_view<CharType> key) noexcept
+        {
+            return std::hash<std::basic_string_view<CharType>>()(key);
+        }
+
+    private:
+
+        struct Node
+        {
+            Node(const KEY& key, size_t hash) noexcept
+                : Hash(hash), Key(key)
+            {}
+
+            std::atomic<u32> References = 1;
+            size_t Hash;
+            KEY Key;
+        };
+
+        static Node* NewNode(const KEY& key, size_t hash) noexcept
+        {
+#if EJSON_ARENA
+            Allocator<Node> allocator;
+            return new (allocator.allocate(1)) Node(key, hash);
+#else
+            return new Node(key, hash);
+#endif
+        }
+
+        static void DeleteNode(Node* node) noexcept
+        {
+#if EJSON_ARENA
+            Allocator<Node> allocator(node->Key.get_allocator());
+            node->~Node();
+            allocator.deallocate(node, 1);
+#else
+            delete node;
+#endif
+        }
+
+        Node* node = nullptr;
+    };
+
+    // Entries in insertion order in one vector, found through an open addressing index of their positions:
+    // iteration walks the vector. As for arrays, adding a key may move the values.
     template<typename KEY, typename VALUE>
     class OrderedMap
     {
@@ -214,15 +385,20 @@ namespace ejson
 
         using KeyValuePair = std::pair<const KEY&, const VALUE&>;
 
+        struct Entry
+        {
+            SharedKey<KEY> Key;
+            VALUE Value;
+        };
+
         class Iterator
         {
-            using KeyIterator = typename std::vector<KEY>::const_iterator;
-            const OrderedMap* dict;
-            KeyIterator it;
+            using EntryIterator = typename vector<Entry>::const_iterator;
+            EntryIterator it;
 
         public:
 
-            Iterator(const OrderedMap* dict, KeyIterator it) : dict(dict), it(EJSON_MOVE(it)) {}
+            Iterator(EntryIterator it) : it(EJSON_MOVE(it)) {}
 
             Iterator& operator++() noexcept
             {
@@ -237,69 +413,169 @@ namespace ejson
 
             KeyValuePair operator*() const noexcept
             {
-                const KEY& key = *it;
-                return KeyValuePair(key, dict->map.at(key));
+                return KeyValuePair(it->Key.Get(), it->Value);
             }
         };
 
-        Iterator begin() const noexcept { return Iterator(this, keys.begin()); }
-        Iterator end() const noexcept { return Iterator(this, keys.end()); }
+        Iterator begin() const noexcept { return Iterator(entries.begin()); }
+        Iterator end() const noexcept { return Iterator(entries.end()); }
 
-        size_t size() const noexcept { return map.size(); }
+        size_t size() const noexcept { return VectorSize(entries); }
+
+#if EJSON_ARENA
+        auto get_allocator() const noexcept { return entries.get_allocator(); }
+#endif
 
         VALUE& operator[](const KEY& key) noexcept
         {
-            VALUE* existing = Find(key);
-            if (existing)
-                return *existing;
             return *TryEmplace(key, {});
         }
 
         const VALUE& operator[](const KEY& key) const noexcept
         {
-            return map[key];
+            const VALUE* value = Find(key);
+            EJSON_ASSERT(value != nullptr, "key not found");
+            return *value;
         }
 
-        auto emplace(const KEY& key, VALUE&& value) noexcept
+        std::pair<VALUE*, bool> emplace(const KEY& key, VALUE&& value) noexcept
         {
-            auto result = map.emplace(key, EJSON_FORWARD<VALUE>(value));
-            if (result.second)
-                keys.push_back(key);
-            return result;
+            const size_t count = VectorSize(entries);
+            VALUE* result = TryEmplace(key, EJSON_FORWARD<VALUE>(value));
+            return { result, VectorSize(entries) != count };
         }
 
         // try add a new value and return it pointer, else return pointer of existing value
-        VALUE* TryEmplace(const KEY& key, const VALUE&& value) noexcept
+        VALUE* TryEmplace(const KEY& key, VALUE&& value) noexcept
+        {
+            const size_t hash = SharedKey<KEY>::Hash(key);
+            if (VectorSize(index) == 0)
+            {
+                const size_t position = FindEntry(key, hash);
+                if (position != VectorSize(entries))
+                    return &entries[position].Value;
+                return Append(SharedKey<KEY>(key, hash), EJSON_FORWARD<VALUE>(value));
+            }
+            const size_t slot = FindSlot(key, hash);
+            if (index[slot] != 0)
+                return &entries[index[slot] - 1].Value;
+            return Insert(SharedKey<KEY>(key, hash), EJSON_FORWARD<VALUE>(value), slot);
+        }
+
+        VALUE* TryEmplace(SharedKey<KEY>&& key, VALUE&& value) noexcept
         {
-            auto result = map.try_emplace(key, EJSON_MOVE(value));
-            if (result.second)
-                keys.push_back(result.first->first);
-            return &result.first->second;
+            if (VectorSize(index) == 0)
+            {
+                const size_t position = FindEntry(key, key.GetHash());
+                if (position != VectorSize(entries))
+                    return &entries[position].Value;
+                return Append(EJSON_FORWARD<SharedKey<KEY>>(key), EJSON_FORWARD<VALUE>(value));
+            }
+            const size_t slot = FindSlot(key, key.GetHash());
+            if (index[slot] != 0)
+                return &entries[index[slot] - 1].Value;
+            return Insert(EJSON_FORWARD<SharedKey<KEY>>(key), EJSON_FORWARD<VALUE>(value), slot);
         }
 
         // find an entry, return it's value ptr if exist, else nullptr
         VALUE* Find(const KEY& key) noexcept
         {
-            auto it = map.find(key);
-            if (it != map.end())
-                return &it->second;
-            else
-                return nullptr;
+            return const_cast<VALUE*>(((const OrderedMap*)this)->Find(key));
         }
 
         const VALUE* Find(const KEY& key) const noexcept
         {
-            auto it = map.find(key);
-            if (it != map.end())
-                return &it->second;
-            else
+            if (VectorSize(index) == 0)
+            {
+                const size_t position = FindEntry(key, SharedKey<KEY>::Hash(key));
+                return position != VectorSize(entries) ? &entries[position].Value : nullptr;
+            }
+            const size_t slot = FindSlot(key, SharedKey<KEY>::Hash(key));
+            if (index[slot] == 0)
                 return nullptr;
+            return &entries[index[slot] - 1].Value;
         }
 
     private:
 
-        std::vector<KEY> keys;
-        std::unordered_map<KEY, VALUE> map;
+        static constexpr size_t SmallSize = EJSON_SMALL_OBJECT;
+        static constexpr size_t MinIndexSize = 8;
+
+        static bool Matches(const SharedKey<KEY>& entryKey, const SharedKey<KEY>& key, size_t) noexcept
+        {
+            return entryKey == key;
+        }
+
+        static bool Matches(const SharedKey<KEY>& entryKey, const KEY& key, size_t hash) noexcept
+        {
+            return entryKey.GetHash() == hash && entryKey.Get() == key;
+        }
+
+        // position of key in a small object (no index), size() if not found. Keys shared by the
+        // reader match on their pointer, other keys on the cached hash before the text
+        template<typename LOOKUP>
+        size_t FindEntry(const LOOKUP& key, size_t hash) const noexcept
+        {
+            const size_t count = VectorSize(entries);
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (Matches(entries[i].Key, key, hash))
+                    return i;
+            }
+            return count;
+        }
+
+        // slot of key in index, or the empty slot where it goes, index is not empty
+        template<typename LOOKUP>
+        size_t FindSlot(const LOOKUP& key, size_t hash) const noexcept
+        {
+            const size_t mask = VectorSize(index) - 1;
+            size_t slot = hash & mask;
+            while (index[slot] != 0 && !Matches(entries[index[slot] - 1].Key, key, hash))
+                slot = (slot + 1) & mask;
+            return slot;
+        }
+
+        // add to a small object, index it once it grows past SmallSize
+        VALUE* Append(SharedKey<KEY>&& key, VALUE&& value) noexcept
+        {
+            entries.push_back(Entry{ EJSON_FORWARD<SharedKey<KEY>>(key), EJSON_FORWARD<VALUE>(value) });
+            if (VectorSize(entries) > SmallSize)
+            {
+                size_t size = MinIndexSize;
+                while (VectorSize(entries) * 2 > size)
+                    size *= 2;
+                Rehash(size);
+            }
+            return &entries[VectorSize(entries) - 1].Value;
+        }
+
+        VALUE* Insert(SharedKey<KEY>&& key, VALUE&& value, size_t slot) noexcept
+        {
+            entries.push_back(Entry{ EJSON_FORWARD<SharedKey<KEY>>(key), EJSON_FORWARD<VALUE>(value) });
+            index[slot] = (u32)VectorSize(entries);
+            // at most half full
+            if (VectorSize(entries) * 2 > VectorSize(index))
+                Rehash(VectorSize(index) * 2);
+            return &entries[VectorSize(entries) - 1].Value;
+        }
+
+        void Rehash(size_t size) noexcept
+        {
+            index.assign(size, 0);
+            const size_t mask = size - 1;
+            for (size_t i = 0; i < VectorSize(entries); ++i)
+            {
+                size_t slot = entries[i].Key.GetHash() & mask;
+                while (index[slot] != 0)
+                    slot = (slot + 1) & mask;
+                index[slot] = (u32)(i + 1);
+            }
+        }
+
+        vector<Entry> entries;
+        // position + 1 of an entry, 0 for an empty slot, empty for small objects
+        vector<u32> index;
     };
 
     template<typename KEY, typename VALUE>
@@ -323,10 +599,21 @@ namespace ejson
         return m.TryEmplace(key, EJSON_FORWARD<VALUE>(value));
     }
 
+    template<typename KEY, typename VALUE>
+    VALUE* MapTryEmplace(map<KEY, VALUE>& m, SharedKey<KEY>&& key, VALUE&& value) noexcept
+    {
+        return m.TryEmplace(EJSON_FORWARD<SharedKey<KEY>>(key), EJSON_FORWARD<VALUE>(value));
+    }
+
 #else // #if EJSON_MAP_ORDERED
 
+#if EJSON_ARENA
+    template<typename KEY, typename VALUE>
+    using map = std::map<KEY, VALUE, std::less<KEY>, Allocator<std::pair<const KEY, VALUE>>>;
+#else
     template<typename KEY, typename VALUE>
     using map = std::map<KEY, VALUE>;
+#endif
 
     template<typename KEY, typename VALUE>
     VALUE* MapFind(map<KEY, VALUE>& m, const KEY& key) noexcept
@@ -338,20 +625,121 @@ namespace ejson
             return nullptr;
     }
 
+    template<typename KEY, typename VALUE>
+    const VALUE* MapFind(const map<KEY, VALUE>& m, const KEY& key) noexcept
+    {
+        auto result = m.find(key);
+        if (result != m.end())
+            return &result->second;
+        else
+            return nullptr;
+    }
+
     template<typename KEY, typename VALUE>
     VALUE* MapTryEmplace(map<KEY, VALUE>& m, const KEY& key, VALUE&& value) noexcept
     {
         auto [it, success] = m.try_emplace(key, EJSON_FORWARD<VALUE>(value));
         return &(it->second);
     }
+
+    template<typename KEY, typename VALUE>
+    VALUE* MapTryEmplace(map<KEY, VALUE>& m, KEY&& key, VALUE&& value) noexcept
+    {
+        auto [it, success] = m.try_emplace(EJSON_FORWARD<KEY>(key), EJSON_FORWARD<VALUE>(value));
+        return &(it->second);
+    }
 #endif // #if EJSON_MAP_ORDERED
 
 }
 #endif // #if EJSON_CONFIG_FILE
 
+// memory map regular files read by ejson::Read(path), set to 0 to always use chunked reads
+#ifndef EJSON_FILE_MAPPING
+    #define EJSON_FILE_MAPPING 1
+#endif
+
+// ValueReader keeps numbers as their text, converted on access and written back unchanged
+#ifndef EJSON_LAZY_NUMBERS
+    #define EJSON_LAZY_NUMBERS 0
+#endif
+
+// Value is 16 bytes: arrays, objects and strings too long to be inline are allocated apart, behind a pointer
+// (one more allocation each, a move only takes the pointer). Default keeps them in the value (56 bytes)
+#ifndef EJSON_VALUE_COMPACT
+    #define EJSON_VALUE_COMPACT 0
+#endif
+
+// instruction set used to scan input: EJSON_SIMD_NONE (portable scalar code), default is detected from compiler flags
+#define EJSON_SIMD_NONE 0
+#define EJSON_SIMD_SSE2 1
+#define EJSON_SIMD_AVX2 2
+#define EJSON_SIMD_NEON 3
+
+#ifndef EJSON_SIMD
+    #if defined(__AVX2__)
+        #define EJSON_SIMD EJSON_SIMD_AVX2
+    #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define EJSON_SIMD EJSON_SIMD_SSE2
+    #elif defined(__aarch64__) || defined(_M_ARM64)
+        #define EJSON_SIMD EJSON_SIMD_NEON
+    #else
+        #define EJSON_SIMD EJSON_SIMD_NONE
+    #endif
+#endif
+
 //
 // End configurations 
 
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#if EJSON_SIMD == EJSON_SIMD_SSE2
+    #include <emmintrin.h>
+#elif EJSON_SIMD == EJSON_SIMD_AVX2
+    #include <immintrin.h>
+#elif EJSON_SIMD == EJSON_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+#if defined(_WIN32)
+    #include <intrin.h>
+
+// the few Win32 calls FileReader needs, declared as windows.h does so it is not pulled in (nor its macros)
+struct _SECURITY_ATTRIBUTES;
+struct _OVERLAPPED;
+union _LARGE_INTEGER;
+extern "C"
+{
+    __declspec(dllimport) void* __stdcall CreateFileW(const wchar_t* fileName, unsigned long desiredAccess, unsigned long shareMode, _SECURITY_ATTRIBUTES* securityAttributes, unsigned long creationDisposition, unsigned long flagsAndAttributes, void* templateFile);
+    __declspec(dllimport) unsigned long __stdcall GetFileType(void* file);
+    __declspec(dllimport) int __stdcall GetFileSizeEx(void* file, _LARGE_INTEGER* fileSize);
+    __declspec(dllimport) void* __stdcall CreateFileMappingW(void* file, _SECURITY_ATTRIBUTES* attributes, unsigned long protect, unsigned long maximumSizeHigh, unsigned long maximumSizeLow, const wchar_t* name);
+    #if defined(_WIN64)
+    __declspec(dllimport) void* __stdcall MapViewOfFile(void* mapping, unsigned long desiredAccess, unsigned long offsetHigh, unsigned long offsetLow, unsigned __int64 numberOfBytesToMap);
+    #else
+    __declspec(dllimport) void* __stdcall MapViewOfFile(void* mapping, unsigned long desiredAccess, unsigned long offsetHigh, unsigned long offsetLow, unsigned long numberOfBytesToMap);
+    #endif
+    __declspec(dllimport) int __stdcall UnmapViewOfFile(const void* baseAddress);
+    __declspec(dllimport) int __stdcall ReadFile(void* file, void* buffer, unsigned long numberOfBytesToRead, unsigned long* numberOfBytesRead, _OVERLAPPED* overlapped);
+    __declspec(dllimport) int __stdcall CloseHandle(void* object);
+}
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 namespace ejson
 {
     struct ParserError
@@ -362,1481 +750,6062 @@ namespace ejson
         string Error;
     };
 
-    inline bool IsDigit(string_char c) noexcept
-    {
-        return c >= EJSON_TEXT('0') && c <= EJSON_TEXT('9');
-    }
+    // Simd
+    //
+    // SimdBlock loads 64 characters narrowed to bytes: ascii is kept as is, anything else saturates to a
+    // byte that is never json syntax (0x7F or 0x80), so char and wchar_t input share the same byte masks.
+    // Masks have one bit per character, bit i is character i.
 
-    inline bool ParseNumber(string_view str, number& result) noexcept
+    class SimdBlock
     {
-        size_t strSize = StringSize(str);
-        number sign = 1.0;
-        bool decimalFound = false;
-        bool digitFound = false;
-        number decimalFactor = 0.1f;
-        result = 0.0;
+    public:
 
-        if (strSize == 0)
-            return false;
+        static constexpr size_t Size = 64;
+
+        SimdBlock(const string_char* input) noexcept
+        {
+#if EJSON_SIMD == EJSON_SIMD_SSE2
+            for (int i = 0; i < 4; ++i)
+                bytes[i] = Load16(input + i * 16);
+#elif EJSON_SIMD == EJSON_SIMD_AVX2
+            bytes[0] = Load32(input);
+            bytes[1] = Load32(input + 32);
+#elif EJSON_SIMD == EJSON_SIMD_NEON
+            for (int i = 0; i < 4; ++i)
+                bytes[i] = Load16(input + i * 16);
+#else
+            for (size_t i = 0; i < Size; ++i)
+            {
+                if constexpr (sizeof(string_char) == 1)
+                    bytes[i] = (u8)input[i];
+                else
+                    bytes[i] = (u8)((std::make_unsigned_t<string_char>)input[i] < 0x80 ? input[i] : 0x80);
+            }
+#endif
+        }
+
+        // characters equal to c
+        u64 Equal(u8 c) const noexcept
+        {
+#if EJSON_SIMD == EJSON_SIMD_SSE2
+            const __m128i value = _mm_set1_epi8((char)c);
+            u64 mask = 0;
+            for (int i = 0; i < 4; ++i)
+                mask |= (u64)(u16)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes[i], value)) << (i * 16);
+            return mask;
+#elif EJSON_SIMD == EJSON_SIMD_AVX2
+            const __m256i value = _mm256_set1_epi8((char)c);
+            return (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes[0], value)) |
+                   (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes[1], value)) << 32;
+#elif EJSON_SIMD == EJSON_SIMD_NEON
+            const uint8x16_t value = vdupq_n_u8(c);
+            return ToMask(vceqq_u8(bytes[0], value), vceqq_u8(bytes[1], value), vceqq_u8(bytes[2], value), vceqq_u8(bytes[3], value));
+#else
+            u64 mask = 0;
+            for (size_t i = 0; i < Size; ++i)
+                mask |= (u64)(bytes[i] == c) << i;
+            return mask;
+#endif
+        }
 
-        size_t i = 0;
-        if (str[i] == EJSON_TEXT('-'))
+        // characters equal to any of chars, compares are merged before building the mask
+        template<typename... CHARS>
+        u64 EqualAny(CHARS... chars) const noexcept
         {
-            sign = -1.0;
-            ++i;
+#if EJSON_SIMD == EJSON_SIMD_SSE2
+            u64 mask = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                __m128i equal = _mm_setzero_si128();
+                ((equal = _mm_or_si128(equal, _mm_cmpeq_epi8(bytes[i], _mm_set1_epi8((char)chars)))), ...);
+                mask |= (u64)(u16)_mm_movemask_epi8(equal) << (i * 16);
+            }
+            return mask;
+#elif EJSON_SIMD == EJSON_SIMD_AVX2
+            __m256i low = _mm256_setzero_si256();
+            __m256i high = _mm256_setzero_si256();
+            ((low = _mm256_or_si256(low, _mm256_cmpeq_epi8(bytes[0], _mm256_set1_epi8((char)chars)))), ...);
+            ((high = _mm256_or_si256(high, _mm256_cmpeq_epi8(bytes[1], _mm256_set1_epi8((char)chars)))), ...);
+            return (u64)(u32)_mm256_movemask_epi8(low) | (u64)(u32)_mm256_movemask_epi8(high) << 32;
+#elif EJSON_SIMD == EJSON_SIMD_NEON
+            uint8x16_t equal[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                equal[i] = vdupq_n_u8(0);
+                ((equal[i] = vorrq_u8(equal[i], vceqq_u8(bytes[i], vdupq_n_u8((u8)chars)))), ...);
+            }
+            return ToMask(equal[0], equal[1], equal[2], equal[3]);
+#else
+            return (Equal((u8)chars) | ...);
+#endif
+        }
+
+        // characters lower or equal to c (unsigned)
+        u64 LessEqual(u8 c) const noexcept
+        {
+#if EJSON_SIMD == EJSON_SIMD_SSE2
+            const __m128i value = _mm_set1_epi8((char)c);
+            u64 mask = 0;
+            for (int i = 0; i < 4; ++i)
+                mask |= (u64)(u16)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(bytes[i], value), value)) << (i * 16);
+            return mask;
+#elif EJSON_SIMD == EJSON_SIMD_AVX2
+            const __m256i value = _mm256_set1_epi8((char)c);
+            return (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(bytes[0], value), value)) |
+                   (u64)(u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(bytes[1], value), value)) << 32;
+#elif EJSON_SIMD == EJSON_SIMD_NEON
+            const uint8x16_t value = vdupq_n_u8(c);
+            return ToMask(vcleq_u8(bytes[0], value), vcleq_u8(bytes[1], value), vcleq_u8(bytes[2], value), vcleq_u8(bytes[3], value));
+#else
+            u64 mask = 0;
+            for (size_t i = 0; i < Size; ++i)
+                mask |= (u64)(bytes[i] <= c) << i;
+            return mask;
+#endif
         }
 
-        for (; i < strSize && str[i] != EJSON_TEXT('e') && str[i] != EJSON_TEXT('E'); ++i)
+    private:
+
+#if EJSON_SIMD == EJSON_SIMD_SSE2
+
+        static __m128i Load16(const string_char* input) noexcept
         {
-            if (IsDigit(str[i]))
+            const __m128i* p = (const __m128i*)input;
+            if constexpr (sizeof(string_char) == 1)
             {
-                if (!decimalFound)
-                {
-                    digitFound = true;
-                    result = result * 10 + (str[i] - EJSON_TEXT('0'));
-                }
-                else
-                {
-                    result += (str[i] - EJSON_TEXT('0')) * decimalFactor;
-                    decimalFactor /= 10;
-                }
+                return _mm_loadu_si128(p);
             }
-            else if (str[i] == EJSON_TEXT('.') && !decimalFound)
+            else if constexpr (sizeof(string_char) == 2)
             {
-                if (!digitFound)
-                    return false;
-                decimalFound = true;
+                return _mm_packs_epi16(_mm_loadu_si128(p), _mm_loadu_si128(p + 1));
             }
             else
             {
-                return false;
+                __m128i low = _mm_packs_epi32(_mm_loadu_si128(p), _mm_loadu_si128(p + 1));
+                __m128i high = _mm_packs_epi32(_mm_loadu_si128(p + 2), _mm_loadu_si128(p + 3));
+                return _mm_packs_epi16(low, high);
             }
         }
 
-        if (i < strSize && (str[i] == EJSON_TEXT('e') || str[i] == EJSON_TEXT('E')))
-        {
-            ++i;
+        __m128i bytes[4];
 
-            if (i >= strSize)
-                return false;
+#elif EJSON_SIMD == EJSON_SIMD_AVX2
 
-            number exponentSign = 1.0;
-            if (str[i] == EJSON_TEXT('+'))
+        static __m256i Load32(const string_char* input) noexcept
+        {
+            // packs works per 128 bits lane, permute puts the 64 bits quarters back in order
+            const __m256i* p = (const __m256i*)input;
+            if constexpr (sizeof(string_char) == 1)
             {
-                ++i;
+                return _mm256_loadu_si256(p);
             }
-            else if (str[i] == EJSON_TEXT('-'))
+            else if constexpr (sizeof(string_char) == 2)
             {
-                exponentSign = -1.0;
-                ++i;
+                return _mm256_permute4x64_epi64(_mm256_packs_epi16(_mm256_loadu_si256(p), _mm256_loadu_si256(p + 1)), 0xD8);
             }
+            else
+            {
+                __m256i low = _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_loadu_si256(p), _mm256_loadu_si256(p + 1)), 0xD8);
+                __m256i high = _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_loadu_si256(p + 2), _mm256_loadu_si256(p + 3)), 0xD8);
+                return _mm256_permute4x64_epi64(_mm256_packs_epi16(low, high), 0xD8);
+            }
+        }
 
-            if (i >= strSize)
-                return false;
+        __m256i bytes[2];
+
+#elif EJSON_SIMD == EJSON_SIMD_NEON
 
-            number exponent = 0.0;
-            for (; i < strSize; ++i)
+        static uint8x16_t Load16(const string_char* input) noexcept
+        {
+            if constexpr (sizeof(string_char) == 1)
             {
-                if (!IsDigit(str[i]))
-                {
-                    return false;
-                }
-                exponent = exponent * 10 + (str[i] - EJSON_TEXT('0'));
+                return vld1q_u8((const u8*)input);
+            }
+            else if constexpr (sizeof(string_char) == 2)
+            {
+                const s16* p = (const s16*)input;
+                return vreinterpretq_u8_s8(vcombine_s8(vqmovn_s16(vld1q_s16(p)), vqmovn_s16(vld1q_s16(p + 8))));
             }
-            while (exponent > 0)
+            else
             {
-                result *= exponentSign > 0.0f ? 10.0f : 0.1f;
-                --exponent;
+                const s32* p = (const s32*)input;
+                int16x8_t low = vcombine_s16(vqmovn_s32(vld1q_s32(p)), vqmovn_s32(vld1q_s32(p + 4)));
+                int16x8_t high = vcombine_s16(vqmovn_s32(vld1q_s32(p + 8)), vqmovn_s32(vld1q_s32(p + 12)));
+                return vreinterpretq_u8_s8(vcombine_s8(vqmovn_s16(low), vqmovn_s16(high)));
             }
         }
 
-        result *= sign;
-        return true;
-    }
+        static u64 ToMask(uint8x16_t m0, uint8x16_t m1, uint8x16_t m2, uint8x16_t m3) noexcept
+        {
+            const uint8x16_t bits = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+            uint8x16_t sum0 = vpaddq_u8(vandq_u8(m0, bits), vandq_u8(m1, bits));
+            uint8x16_t sum1 = vpaddq_u8(vandq_u8(m2, bits), vandq_u8(m3, bits));
+            sum0 = vpaddq_u8(sum0, sum1);
+            sum0 = vpaddq_u8(sum0, sum0);
+            return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+        }
 
-    class Value
-    {
-    public:
+        uint8x16_t bytes[4];
 
-        enum class Type : std::uint8_t
-        {
-            Invalid,
-            Null,
-            Bool,
-            Number,
-            String,
-            Array,
-            Object
-        };
+#else
 
-        Value() = default;
+        u8 bytes[Size];
 
-        Value(const Value& value) noexcept
+#endif
+    };
+
+    // skip ' ', '\t' and '\n' from begin, return the first other character (or end)
+    inline const string_char* SkipWhitespaces(const string_char* begin, const string_char* end) noexcept
+    {
+        const string_char* p = begin;
+
+        // most runs are a single space, don't pay a block load for them
+        if (p != end && *p != EJSON_TEXT(' ') && *p != EJSON_TEXT('\t') && *p != EJSON_TEXT('\n'))
+            return p;
+
+        while ((size_t)(end - p) >= SimdBlock::Size)
         {
-            Set(value);
+            const u64 space = SimdBlock(p).EqualAny(' ', '\t', '\n');
+            if (space != ~0ull)
+                return p + std::countr_one(space);
+            p += SimdBlock::Size;
         }
 
-        Value(Value&& value) noexcept
+        for (; p != end; ++p)
         {
-            Set(EJSON_FORWARD<Value>(value));
+            if (*p != EJSON_TEXT(' ') && *p != EJSON_TEXT('\t') && *p != EJSON_TEXT('\n'))
+                break;
         }
+        return p;
+    }
 
-        ~Value() noexcept
+    // first '"', '\\' or control character from begin (or end)
+    inline const string_char* ScanString(const string_char* begin, const string_char* end) noexcept
+    {
+        const auto isSpecial = [](string_char c) noexcept
         {
-            SetInvalid();
+            return c == EJSON_TEXT('"') || c == EJSON_TEXT('\\') || (std::make_unsigned_t<string_char>)c <= 0x1F;
+        };
+
+        // keys and short values end before a block load pays off
+        const string_char* p = begin;
+        const string_char* shortEnd = (size_t)(end - p) > 16 ? p + 16 : end;
+        for (; p != shortEnd; ++p)
+        {
+            if (isSpecial(*p))
+                return p;
         }
 
-        Value& operator=(const Value& other) noexcept
+        while ((size_t)(end - p) >= SimdBlock::Size)
         {
-            if (this != &other)
-            {
-                Set(other);
-            }
-            return *this;
+            SimdBlock block(p);
+            const u64 special = block.Equal('"') | block.Equal('\\') | block.LessEqual(0x1F);
+            if (special != 0)
+                return p + std::countr_zero(special);
+            p += SimdBlock::Size;
         }
 
-        Type GetType() const noexcept
+        for (; p != end; ++p)
         {
-            return type;
+            if (isSpecial(*p))
+                break;
         }
+        return p;
+    }
 
-        // Value
-        void Set(const Value& other) noexcept
+    // bit i of the result is the xor of bits 0 to i: quote masks become "inside a string" masks
+    inline u64 PrefixXor(u64 bits) noexcept
+    {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    // characters escaped by a backslash: a run of backslashes of odd length escapes the character following it.
+    // escapedCarry is 1 when the first character of the block is escaped, it is updated for the next block.
+    inline u64 FindEscaped(u64 backslash, u64& escapedCarry) noexcept
+    {
+        constexpr u64 evenBits = 0x5555555555555555ull;
+
+        backslash &= ~escapedCarry;
+        const u64 followsEscape = (backslash << 1) | escapedCarry;
+        // adding the run starts that are on odd bits to the runs carries them to the end of their run,
+        // the parity of the start and the length of the run then give the escaped character parity
+        const u64 oddStarts = backslash & ~evenBits & ~followsEscape;
+        const u64 evenStartsEnds = oddStarts + backslash;
+        escapedCarry = evenStartsEnds < oddStarts ? 1 : 0;
+        const u64 invertMask = evenStartsEnds << 1;
+        return (evenBits ^ invertMask) & followsEscape;
+    }
+
+    // state of SkipNested between spans
+    struct NestedSkip
+    {
+        // brackets still open
+        u32 Depth = 0;
+        bool InString = false;
+        // the next character follows an odd run of backslashes
+        bool Escaped = false;
+    };
+
+    // Skips the inside of containers without tokenizing: strings are jumped over, '{' '[' and '}' ']' are
+    // counted alike. Returns the character following the bracket closing the last open one (Depth is then 0),
+    // end when the span ends first, or the '\0' ending the input.
+    inline const string_char* SkipNested(const string_char* begin, const string_char* end, NestedSkip& skip) noexcept
+    {
+        const string_char* p = begin;
+        while (p != end)
         {
-            switch (other.type)
+            if ((size_t)(end - p) >= SimdBlock::Size)
             {
-                case Type::Invalid:
-                    SetInvalid();
-                    break;
-                case Type::Null:
-                    SetNull();
-                    break;
-                case Type::Bool:
-                    SetBool(other.AsBool());
-                    break;
-                case Type::Number:
-                    SetNumber(other.AsNumber());
-                    break;
-                case Type::String:
-                    SetString(other.AsString());
-                    break;
-                case Type::Array:
-                    SetArray(other.AsArray());
-                    break;
-                case Type::Object:
-                    SetObject(other.AsObject());
-                    break;
+                const SimdBlock block(p);
+                if (block.Equal(0) == 0)
+                {
+                    u64 escapedCarry = skip.Escaped ? 1 : 0;
+                    const u64 escaped = FindEscaped(block.Equal('\\'), escapedCarry);
+                    const u64 quote = block.Equal('"') & ~escaped;
+                    const u64 inside = PrefixXor(quote) ^ (skip.InString ? ~0ull : 0);
+                    const u64 open = block.EqualAny('{', '[') & ~inside;
+                    const u64 close = block.EqualAny('}', ']') & ~inside;
+
+                    if ((u32)std::popcount(close) < skip.Depth)
+                    {
+                        // the last bracket cannot close in this block
+                        skip.Depth += (u32)std::popcount(open) - (u32)std::popcount(close);
+                    }
+                    else
+                    {
+                        for (u64 brackets = open | close; brackets != 0; brackets &= brackets - 1)
+                        {
+                            const u64 bit = brackets & (0 - brackets);
+                            if (open & bit)
+                                ++skip.Depth;
+                            else if (--skip.Depth == 0)
+                                return p + std::countr_zero(bit) + 1;
+                        }
+                    }
+                    skip.Escaped = escapedCarry != 0;
+                    skip.InString = (inside >> 63) != 0;
+                    p += SimdBlock::Size;
+                    continue;
+                }
             }
-        }
 
-        void Set(Value&& other) noexcept
-        {
-            switch (other.type)
+            // a block holding '\0' or the end of the span
+            const string_char* blockEnd = p + std::min((size_t)(end - p), SimdBlock::Size);
+            for (; p != blockEnd; ++p)
             {
-                case Type::Invalid:
-                    SetInvalid();
-                    break;
-                case Type::Null:
-                    SetNull();
-                    break;
-                case Type::Bool:
-                    SetBool(other.AsBool());
-                    break;
-                case Type::Number:
-                    SetNumber(other.AsNumber());
-                    break;
-                case Type::String:
-                    SetString(EJSON_FORWARD<string>(other.AsString()));
-                    break;
-                case Type::Array:
-                    SetArray(EJSON_FORWARD<vector<Value>>(other.AsArray()));
-                    break;
-                case Type::Object:
-                    SetObject(EJSON_FORWARD<map<string, Value>>(other.AsObject()));
-                    break;
+                const string_char c = *p;
+                if (c == 0)
+                    return p;
+                if (skip.Escaped)
+                {
+                    // like the structural index, a backslash only escapes a quote or another backslash
+                    skip.Escaped = false;
+                    if (c == EJSON_TEXT('"') || c == EJSON_TEXT('\\'))
+                        continue;
+                }
+                else if (c == EJSON_TEXT('\\'))
+                {
+                    skip.Escaped = true;
+                    continue;
+                }
+                if (skip.InString)
+                {
+                    if (c == EJSON_TEXT('"'))
+                        skip.InString = false;
+                    continue;
+                }
+                switch (c)
+                {
+                    case EJSON_TEXT('"'):
+                        skip.InString = true;
+                        break;
+                    case EJSON_TEXT('{'):
+                    case EJSON_TEXT('['):
+                        ++skip.Depth;
+                        break;
+                    case EJSON_TEXT('}'):
+                    case EJSON_TEXT(']'):
+                        if (--skip.Depth == 0)
+                            return p + 1;
+                        break;
+                }
             }
-            other.type = Type::Invalid;
         }
+        return end;
+    }
 
-        // Invalid
-
-        bool IsInvalid() const noexcept
-        {
-            return type == Type::Invalid;
-        }
+    // advance a position over [begin, end): '\n' starts a new line, lineChars counts the characters of the
+    // current line, so the column of the character at end is lineChars + 1
+    inline void CountLines(const string_char* begin, const string_char* end, u32& line, u32& lineChars) noexcept
+    {
+        const string_char* lineBegin = nullptr;
+        const string_char* cur = begin;
 
-        bool IsValid() const noexcept
+        while ((size_t)(end - cur) >= SimdBlock::Size)
         {
-            return !IsInvalid();
+            const u64 newline = SimdBlock(cur).Equal('\n');
+            if (newline != 0)
+            {
+                line += (u32)std::popcount(newline);
+                lineBegin = cur + (63 - std::countl_zero(newline)) + 1;
+            }
+            cur += SimdBlock::Size;
         }
 
-        void SetInvalid() noexcept
+        for (; cur != end; ++cur)
         {
-            switch (type)
+            if (*cur == EJSON_TEXT('\n'))
             {
-                case Type::Invalid:
-                    break;
-                case Type::Null:
-                    break;
-                case Type::Bool:
-                    break;
-                case Type::Number:
-                    break;
-                case Type::String:
-                    ((string*)buffer)->~string();
-                    break;
-                case Type::Array:
-                    using vectorType = vector<Value>;
-                    ((vectorType*)buffer)->~vectorType();
-                    break;
-                case Type::Object:
-                    using mapType = map<string, Value>;
-                    ((mapType*)buffer)->~mapType();
-                    break;
+                ++line;
+                lineBegin = cur + 1;
             }
-            type = Type::Invalid;
         }
 
-        // Null
+        if (lineBegin != nullptr)
+            lineChars = (u32)(end - lineBegin);
+        else
+            lineChars += (u32)(end - begin);
+    }
 
-        Value(std::nullptr_t v) noexcept
-        {
-            SetNull();
-        }
+    // Numbers
+    //
+    // ParseNumber is correctly rounded (the double nearest to the decimal, ties to even): digits are accumulated
+    // in a 64 bit mantissa, eight at a time when they are plain digits. Mantissas up to 2^53 with exponents up to
+    // 22 are exact in double (Clinger fast path), others go through Eisel-Lemire on 128 bit powers of five, the
+    // rare inputs it cannot decide (more than 19 significant digits, ambiguous products) fall back to
+    // std::from_chars. With number as float the double is then rounded to float.
 
-        Value& operator=(std::nullptr_t v) noexcept
-        {
-            SetNull();
-            return *this;
-        }
+    // a * b on 128 bits, returns the low part
+    inline u64 Multiply128(u64 a, u64 b, u64& high) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        __extension__ typedef unsigned __int128 u128;
+        const u128 product = (u128)a * b;
+        high = (u64)(product >> 64);
+        return (u64)product;
+#elif defined(_M_X64)
+        return _umul128(a, b, &high);
+#else
+        const u64 aLow = (u32)a;
+        const u64 aHigh = a >> 32;
+        const u64 bLow = (u32)b;
+        const u64 bHigh = b >> 32;
+        const u64 lowLow = aLow * bLow;
+        const u64 highLow = aHigh * bLow;
+        const u64 lowHigh = aLow * bHigh;
+        const u64 middle = (lowLow >> 32) + (u32)highLow + (u32)lowHigh;
+        high = aHigh * bHigh + (highLow >> 32) + (lowHigh >> 32) + (middle >> 32);
+        return (middle << 32) | (u32)lowLow;
+#endif
+    }
 
-        bool IsNull() const noexcept
+    struct PowerOfFive
+    {
+        u64 High;
+        u64 Low;
+    };
+
+    constexpr int PowerOfFiveMin = -342;
+    constexpr int PowerOfFiveMax = 308;
+
+    // 5^q for q in [PowerOfFiveMin, PowerOfFiveMax] normalized to 128 bits with the top bit set, truncated for
+    // q >= 0, rounded up for q < 0 (the fast_float table):
+    //     q < 0:  c = 2^b / 5^-q + 1 with b = z + 127 for q >= -27, b = 2z + 128 below (2^z the first power of two
+    //             above 5^-q), then halved until it fits 128 bits
+    //     q >= 0: 5^q doubled or halved until its top bit is bit 127
+    inline constexpr PowerOfFive PowersOfFive[PowerOfFiveMax - PowerOfFiveMin + 1] =
+    {
+            { 0xeef453d6923bd65aull, 0x113faa2906a13b3full }, { 0x9558b4661b6565f8ull, 0x4ac7ca59a424c507ull },
+            { 0xbaaee17fa23ebf76ull, 0x5d79bcf00d2df649ull }, { 0xe95a99df8ace6f53ull, 0xf4d82c2c107973dcull },
+            { 0x91d8a02bb6c10594ull, 0x79071b9b8a4be869ull }, { 0xb64ec836a47146f9ull, 0x9748e2826cdee284ull },
+            { 0xe3e27a444d8d98b7ull, 0xfd1b1b2308169b25ull }, { 0x8e6d8c6ab0787f72ull, 0xfe30f0f5e50e20f7ull },
+            { 0xb208ef855c969f4full, 0xbdbd2d335e51a935ull }, { 0xde8b2b66b3bc4723ull, 0xad2c788035e61382ull },
+            { 0x8b16fb203055ac76ull, 0x4c3bcb5021afcc31ull }, { 0xaddcb9e83c6b1793ull, 0xdf4abe242a1bbf3dull },
+            { 0xd953e8624b85dd78ull, 0xd71d6dad34a2af0dull }, { 0x87d4713d6f33aa6bull, 0x8672648c40e5ad68ull },
+            { 0xa9c98d8ccb009506ull, 0x680efdaf511f18c2ull }, { 0xd43bf0effdc0ba48ull, 0x0212bd1b2566def2ull },
+            { 0x84a57695fe98746dull, 0x014bb630f7604b57ull }, { 0xa5ced43b7e3e9188ull, 0x419ea3bd35385e2dull },
+            { 0xcf42894a5dce35eaull, 0x52064cac828675b9ull }, { 0x818995ce7aa0e1b2ull, 0x7343efebd1940993ull },
+            { 0xa1ebfb4219491a1full, 0x1014ebe6c5f90bf8ull }, { 0xca66fa129f9b60a6ull, 0xd41a26e077774ef6ull },
+            { 0xfd00b897478238d0ull, 0x8920b098955522b4ull }, { 0x9e20735e8cb16382ull, 0x55b46e5f5d5535b0ull },
+            { 0xc5a890362fddbc62ull, 0xeb2189f734aa831dull }, { 0xf712b443bbd52b7bull, 0xa5e9ec7501d523e4ull },
+            { 0x9a6bb0aa55653b2dull, 0x47b233c92125366eull }, { 0xc1069cd4eabe89f8ull, 0x999ec0bb696e840aull },
+            { 0xf148440a256e2c76ull, 0xc00670ea43ca250dull }, { 0x96cd2a865764dbcaull, 0x380406926a5e5728ull },
+            { 0xbc807527ed3e12bcull, 0xc605083704f5ecf2ull }, { 0xeba09271e88d976bull, 0xf7864a44c633682eull },
+            { 0x93445b8731587ea3ull, 0x7ab3ee6afbe0211dull }, { 0xb8157268fdae9e4cull, 0x5960ea05bad82964ull },
+            { 0xe61acf033d1a45dfull, 0x6fb92487298e33bdull }, { 0x8fd0c16206306babull, 0xa5d3b6d479f8e056ull },
+            { 0xb3c4f1ba87bc8696ull, 0x8f48a4899877186cull }, { 0xe0b62e2929aba83cull, 0x331acdabfe94de87ull },
+            { 0x8c71dcd9ba0b4925ull, 0x9ff0c08b7f1d0b14ull }, { 0xaf8e5410288e1b6full, 0x07ecf0ae5ee44dd9ull },
+            { 0xdb71e91432b1a24aull, 0xc9e82cd9f69d6150ull }, { 0x892731ac9faf056eull, 0xbe311c083a225cd2ull },
+            { 0xab70fe17c79ac6caull, 0x6dbd630a48aaf406ull }, { 0xd64d3d9db981787dull, 0x092cbbccdad5b108ull },
+            { 0x85f0468293f0eb4eull, 0x25bbf56008c58ea5ull }, { 0xa76c582338ed2621ull, 0xaf2af2b80af6f24eull },
+            { 0xd1476e2c07286faaull, 0x1af5af660db4aee1ull }, { 0x82cca4db847945caull, 0x50d98d9fc890ed4dull },
+            { 0xa37fce126597973cull, 0xe50ff107bab528a0ull }, { 0xcc5fc196fefd7d0cull, 0x1e53ed49a96272c8ull },
+            { 0xff77b1fcbebcdc4full, 0x25e8e89c13bb0f7aull }, { 0x9faacf3df73609b1ull, 0x77b191618c54e9acull },
+            { 0xc795830d75038c1dull, 0xd59df5b9ef6a2417ull }, { 0xf97ae3d0d2446f25ull, 0x4b0573286b44ad1dull },
+            { 0x9becce62836ac577ull, 0x4ee367f9430aec32ull }, { 0xc2e801fb244576d5ull, 0x229c41f793cda73full },
+            { 0xf3a20279ed56d48aull, 0x6b43527578c1110full }, { 0x9845418c345644d6ull, 0x830a13896b78aaa9ull },
+            { 0xbe5691ef416bd60cull, 0x23cc986bc656d553ull }, { 0xedec366b11c6cb8full, 0x2cbfbe86b7ec8aa8ull },
+            { 0x94b3a202eb1c3f39ull, 0x7bf7d71432f3d6a9ull }, { 0xb9e08a83a5e34f07ull, 0xdaf5ccd93fb0cc53ull },
+            { 0xe858ad248f5c22c9ull, 0xd1b3400f8f9cff68ull }, { 0x91376c36d99995beull, 0x23100809b9c21fa1ull },
+            { 0xb58547448ffffb2dull, 0xabd40a0c2832a78aull }, { 0xe2e69915b3fff9f9ull, 0x16c90c8f323f516cull },
+            { 0x8dd01fad907ffc3bull, 0xae3da7d97f6792e3ull }, { 0xb1442798f49ffb4aull, 0x99cd11cfdf41779cull },
+            { 0xdd95317f31c7fa1dull, 0x40405643d711d583ull }, { 0x8a7d3eef7f1cfc52ull, 0x482835ea666b2572ull },
+            { 0xad1c8eab5ee43b66ull, 0xda3243650005eecfull }, { 0xd863b256369d4a40ull, 0x90bed43e40076a82ull },
+            { 0x873e4f75e2224e68ull, 0x5a7744a6e804a291ull }, { 0xa90de3535aaae202ull, 0x711515d0a205cb36ull },
+            { 0xd3515c2831559a83ull, 0x0d5a5b44ca873e03ull }, { 0x8412d9991ed58091ull, 0xe858790afe9486c2ull },
+            { 0xa5178fff668ae0b6ull, 0x626e974dbe39a872ull }, { 0xce5d73ff402d98e3ull, 0xfb0a3d212dc8128full },
+            { 0x80fa687f881c7f8eull, 0x7ce66634bc9d0b99ull }, { 0xa139029f6a239f72ull, 0x1c1fffc1ebc44e80ull },
+            { 0xc987434744ac874eull, 0xa327ffb266b56220ull }, { 0xfbe9141915d7a922ull, 0x4bf1ff9f0062baa8ull },
+            { 0x9d71ac8fada6c9b5ull, 0x6f773fc3603db4a9ull }, { 0xc4ce17b399107c22ull, 0xcb550fb4384d21d3ull },
+            { 0xf6019da07f549b2bull, 0x7e2a53a146606a48ull }, { 0x99c102844f94e0fbull, 0x2eda7444cbfc426dull },
+            { 0xc0314325637a1939ull, 0xfa911155fefb5308ull }, { 0xf03d93eebc589f88ull, 0x793555ab7eba27caull },
+            { 0x96267c7535b763b5ull, 0x4bc1558b2f3458deull }, { 0xbbb01b9283253ca2ull, 0x9eb1aaedfb016f16ull },
+            { 0xea9c227723ee8bcbull, 0x465e15a979c1cadcull }, { 0x92a1958a7675175full, 0x0bfacd89ec191ec9ull },
+            { 0xb749faed14125d36ull, 0xcef980ec671f667bull }, { 0xe51c79a85916f484ull, 0x82b7e12780e7401aull },
+            { 0x8f31cc0937ae58d2ull, 0xd1b2ecb8b0908810ull }, { 0xb2fe3f0b8599ef07ull, 0x861fa7e6dcb4aa15ull },
+            { 0xdfbdcece67006ac9ull, 0x67a791e093e1d49aull }, { 0x8bd6a141006042bdull, 0xe0c8bb2c5c6d24e0ull },
+            { 0xaecc49914078536dull, 0x58fae9f773886e18ull }, { 0xda7f5bf590966848ull, 0xaf39a475506a899eull },
+            { 0x888f99797a5e012dull, 0x6d8406c952429603ull }, { 0xaab37fd7d8f58178ull, 0xc8e5087ba6d33b83ull },
+            { 0xd5605fcdcf32e1d6ull, 0xfb1e4a9a90880a64ull }, { 0x855c3be0a17fcd26ull, 0x5cf2eea09a55067full },
+            { 0xa6b34ad8c9dfc06full, 0xf42faa48c0ea481eull }, { 0xd0601d8efc57b08bull, 0xf13b94daf124da26ull },
+            { 0x823c12795db6ce57ull, 0x76c53d08d6b70858ull }, { 0xa2cb1717b52481edull, 0x54768c4b0c64ca6eull },
+            { 0xcb7ddcdda26da268ull, 0xa9942f5dcf7dfd09ull }, { 0xfe5d54150b090b02ull, 0xd3f93b35435d7c4cull },
+            { 0x9efa548d26e5a6e1ull, 0xc47bc5014a1a6dafull }, { 0xc6b8e9b0709f109aull, 0x359ab6419ca1091bull },
+            { 0xf867241c8cc6d4c0ull, 0xc30163d203c94b62ull }, { 0x9b407691d7fc44f8ull, 0x79e0de63425dcf1dull },
+            { 0xc21094364dfb5636ull, 0x985915fc12f542e4ull }, { 0xf294b943e17a2bc4ull, 0x3e6f5b7b17b2939dull },
+            { 0x979cf3ca6cec5b5aull, 0xa705992ceecf9c42ull }, { 0xbd8430bd08277231ull, 0x50c6ff782a838353ull },
+            { 0xece53cec4a314ebdull, 0xa4f8bf5635246428ull }, { 0x940f4613ae5ed136ull, 0x871b7795e136be99ull },
+            { 0xb913179899f68584ull, 0x28e2557b59846e3full }, { 0xe757dd7ec07426e5ull, 0x331aeada2fe589cfull },
+            { 0x9096ea6f3848984full, 0x3ff0d2c85def7621ull }, { 0xb4bca50b065abe63ull, 0x0fed077a756b53a9ull },
+            { 0xe1ebce4dc7f16dfbull, 0xd3e8495912c62894ull }, { 0x8d3360f09cf6e4bdull, 0x64712dd7abbbd95cull },
+            { 0xb080392cc4349decull, 0xbd8d794d96aacfb3ull }, { 0xdca04777f541c567ull, 0xecf0d7a0fc5583a0ull },
+            { 0x89e42caaf9491b60ull, 0xf41686c49db57244ull }, { 0xac5d37d5b79b6239ull, 0x311c2875c522ced5ull },
+            { 0xd77485cb25823ac7ull, 0x7d633293366b828bull }, { 0x86a8d39ef77164bcull, 0xae5dff9c02033197ull },
+            { 0xa8530886b54dbdebull, 0xd9f57f830283fdfcull }, { 0xd267caa862a12d66ull, 0xd072df63c324fd7bull },
+            { 0x8380dea93da4bc60ull, 0x4247cb9e59f71e6dull }, { 0xa46116538d0deb78ull, 0x52d9be85f074e608ull },
+            { 0xcd795be870516656ull, 0x67902e276c921f8bull }, { 0x806bd9714632dff6ull, 0x00ba1cd8a3db53b6ull },
+            { 0xa086cfcd97bf97f3ull, 0x80e8a40eccd228a4ull }, { 0xc8a883c0fdaf7df0ull, 0x6122cd128006b2cdull },
+            { 0xfad2a4b13d1b5d6cull, 0x796b805720085f81ull }, { 0x9cc3a6eec6311a63ull, 0xcbe3303674053bb0ull },
+            { 0xc3f490aa77bd60fcull, 0xbedbfc4411068a9cull }, { 0xf4f1b4d515acb93bull, 0xee92fb5515482d44ull },
+            { 0x991711052d8bf3c5ull, 0x751bdd152d4d1c4aull }, { 0xbf5cd54678eef0b6ull, 0xd262d45a78a0635dull },
+            { 0xef340a98172aace4ull, 0x86fb897116c87c34ull }, { 0x9580869f0e7aac0eull, 0xd45d35e6ae3d4da0ull },
+            { 0xbae0a846d2195712ull, 0x8974836059cca109ull }, { 0xe998d258869facd7ull, 0x2bd1a438703fc94bull },
+            { 0x91ff83775423cc06ull, 0x7b6306a34627ddcfull }, { 0xb67f6455292cbf08ull, 0x1a3bc84c17b1d542ull },
+            { 0xe41f3d6a7377eecaull, 0x20caba5f1d9e4a93ull }, { 0x8e938662882af53eull, 0x547eb47b7282ee9cull },
+            { 0xb23867fb2a35b28dull, 0xe99e619a4f23aa43ull }, { 0xdec681f9f4c31f31ull, 0x6405fa00e2ec94d4ull },
+            { 0x8b3c113c38f9f37eull, 0xde83bc408dd3dd04ull }, { 0xae0b158b4738705eull, 0x9624ab50b148d445ull },
+            { 0xd98ddaee19068c76ull, 0x3badd624dd9b0957ull }, { 0x87f8a8d4cfa417c9ull, 0xe54ca5d70a80e5d6ull },
+            { 0xa9f6d30a038d1dbcull, 0x5e9fcf4ccd211f4cull }, { 0xd47487cc8470652bull, 0x7647c3200069671full },
+            { 0x84c8d4dfd2c63f3bull, 0x29ecd9f40041e073ull }, { 0xa5fb0a17c777cf09ull, 0xf468107100525890ull },
+            { 0xcf79cc9db955c2ccull, 0x7182148d4066eeb4ull }, { 0x81ac1fe293d599bfull, 0xc6f14cd848405530ull },
+            { 0xa21727db38cb002full, 0xb8ada00e5a506a7cull }, { 0xca9cf1d206fdc03bull, 0xa6d90811f0e4851cull },
+            { 0xfd442e4688bd304aull, 0x908f4a166d1da663ull }, { 0x9e4a9cec15763e2eull, 0x9a598e4e043287feull },
+            { 0xc5dd44271ad3cdbaull, 0x40eff1e1853f29fdull }, { 0xf7549530e188c128ull, 0xd12bee59e68ef47cull },
+            { 0x9a94dd3e8cf578b9ull, 0x82bb74f8301958ceull }, { 0xc13a148e3032d6e7ull, 0xe36a52363c1faf01ull },
+            { 0xf18899b1bc3f8ca1ull, 0xdc44e6c3cb279ac1ull }, { 0x96f5600f15a7b7e5ull, 0x29ab103a5ef8c0b9ull },
+            { 0xbcb2b812db11a5deull, 0x7415d448f6b6f0e7ull }, { 0xebdf661791d60f56ull, 0x111b495b3464ad21ull },
+            { 0x936b9fcebb25c995ull, 0xcab10dd900beec34ull }, { 0xb84687c269ef3bfbull, 0x3d5d514f40eea742ull },
+            { 0xe65829b3046b0afaull, 0x0cb4a5a3112a5112ull }, { 0x8ff71a0fe2c2e6dcull, 0x47f0e785eaba72abull },
+            { 0xb3f4e093db73a093ull, 0x59ed216765690f56ull }, { 0xe0f218b8d25088b8ull, 0x306869c13ec3532cull },
+            { 0x8c974f7383725573ull, 0x1e414218c73a13fbull }, { 0xafbd2350644eeacfull, 0xe5d1929ef90898faull },
+            { 0xdbac6c247d62a583ull, 0xdf45f746b74abf39ull }, { 0x894bc396ce5da772ull, 0x6b8bba8c328eb783ull },
+            { 0xab9eb47c81f5114full, 0x066ea92f3f326564ull }, { 0xd686619ba27255a2ull, 0xc80a537b0efefebdull },
+            { 0x8613fd0145877585ull, 0xbd06742ce95f5f36ull }, { 0xa798fc4196e952e7ull, 0x2c48113823b73704ull },
+            { 0xd17f3b51fca3a7a0ull, 0xf75a15862ca504c5ull }, { 0x82ef85133de648c4ull, 0x9a984d73dbe722fbull },
+            { 0xa3ab66580d5fdaf5ull, 0xc13e60d0d2e0ebbaull }, { 0xcc963fee10b7d1b3ull, 0x318df905079926a8ull },
+            { 0xffbbcfe994e5c61full, 0xfdf17746497f7052ull }, { 0x9fd561f1fd0f9bd3ull, 0xfeb6ea8bedefa633ull },
+            { 0xc7caba6e7c5382c8ull, 0xfe64a52ee96b8fc0ull }, { 0xf9bd690a1b68637bull, 0x3dfdce7aa3c673b0ull },
+            { 0x9c1661a651213e2dull, 0x06bea10ca65c084eull }, { 0xc31bfa0fe5698db8ull, 0x486e494fcff30a62ull },
+            { 0xf3e2f893dec3f126ull, 0x5a89dba3c3efccfaull }, { 0x986ddb5c6b3a76b7ull, 0xf89629465a75e01cull },
+            { 0xbe89523386091465ull, 0xf6bbb397f1135823ull }, { 0xee2ba6c0678b597full, 0x746aa07ded582e2cull },
+            { 0x94db483840b717efull, 0xa8c2a44eb4571cdcull }, { 0xba121a4650e4ddebull, 0x92f34d62616ce413ull },
+            { 0xe896a0d7e51e1566ull, 0x77b020baf9c81d17ull }, { 0x915e2486ef32cd60ull, 0x0ace1474dc1d122eull },
+            { 0xb5b5ada8aaff80b8ull, 0x0d819992132456baull }, { 0xe3231912d5bf60e6ull, 0x10e1fff697ed6c69ull },
+            { 0x8df5efabc5979c8full, 0xca8d3ffa1ef463c1ull }, { 0xb1736b96b6fd83b3ull, 0xbd308ff8a6b17cb2ull },
+            { 0xddd0467c64bce4a0ull, 0xac7cb3f6d05ddbdeull }, { 0x8aa22c0dbef60ee4ull, 0x6bcdf07a423aa96bull },
+            { 0xad4ab7112eb3929dull, 0x86c16c98d2c953c6ull }, { 0xd89d64d57a607744ull, 0xe871c7bf077ba8b7ull },
+            { 0x87625f056c7c4a8bull, 0x11471cd764ad4972ull }, { 0xa93af6c6c79b5d2dull, 0xd598e40d3dd89bcfull },
+            { 0xd389b47879823479ull, 0x4aff1d108d4ec2c3ull }, { 0x843610cb4bf160cbull, 0xcedf722a585139baull },
+            { 0xa54394fe1eedb8feull, 0xc2974eb4ee658828ull }, { 0xce947a3da6a9273eull, 0x733d226229feea32ull },
+            { 0x811ccc668829b887ull, 0x0806357d5a3f525full }, { 0xa163ff802a3426a8ull, 0xca07c2dcb0cf26f7ull },
+            { 0xc9bcff6034c13052ull, 0xfc89b393dd02f0b5ull }, { 0xfc2c3f3841f17c67ull, 0xbbac2078d443ace2ull },
+            { 0x9d9ba7832936edc0ull, 0xd54b944b84aa4c0dull }, { 0xc5029163f384a931ull, 0x0a9e795e65d4df11ull },
+            { 0xf64335bcf065d37dull, 0x4d4617b5ff4a16d5ull }, { 0x99ea0196163fa42eull, 0x504bced1bf8e4e45ull },
+            { 0xc06481fb9bcf8d39ull, 0xe45ec2862f71e1d6ull }, { 0xf07da27a82c37088ull, 0x5d767327bb4e5a4cull },
+            { 0x964e858c91ba2655ull, 0x3a6a07f8d510f86full }, { 0xbbe226efb628afeaull, 0x890489f70a55368bull },
+            { 0xeadab0aba3b2dbe5ull, 0x2b45ac74ccea842eull }, { 0x92c8ae6b464fc96full, 0x3b0b8bc90012929dull },
+            { 0xb77ada0617e3bbcbull, 0x09ce6ebb40173744ull }, { 0xe55990879ddcaabdull, 0xcc420a6a101d0515ull },
+            { 0x8f57fa54c2a9eab6ull, 0x9fa946824a12232dull }, { 0xb32df8e9f3546564ull, 0x47939822dc96abf9ull },
+            { 0xdff9772470297ebdull, 0x59787e2b93bc56f7ull }, { 0x8bfbea76c619ef36ull, 0x57eb4edb3c55b65aull },
+            { 0xaefae51477a06b03ull, 0xede622920b6b23f1ull }, { 0xdab99e59958885c4ull, 0xe95fab368e45ecedull },
+            { 0x88b402f7fd75539bull, 0x11dbcb0218ebb414ull }, { 0xaae103b5fcd2a881ull, 0xd652bdc29f26a119ull },
+            { 0xd59944a37c0752a2ull, 0x4be76d3346f0495full }, { 0x857fcae62d8493a5ull, 0x6f70a4400c562ddbull },
+            { 0xa6dfbd9fb8e5b88eull, 0xcb4ccd500f6bb952ull }, { 0xd097ad07a71f26b2ull, 0x7e2000a41346a7a7ull },
+            { 0x825ecc24c873782full, 0x8ed400668c0c28c8ull }, { 0xa2f67f2dfa90563bull, 0x728900802f0f32faull },
+            { 0xcbb41ef979346bcaull, 0x4f2b40a03ad2ffb9ull }, { 0xfea126b7d78186bcull, 0xe2f610c84987bfa8ull },
+            { 0x9f24b832e6b0f436ull, 0x0dd9ca7d2df4d7c9ull }, { 0xc6ede63fa05d3143ull, 0x91503d1c79720dbbull },
+            { 0xf8a95fcf88747d94ull, 0x75a44c6397ce912aull }, { 0x9b69dbe1b548ce7cull, 0xc986afbe3ee11abaull },
+            { 0xc24452da229b021bull, 0xfbe85badce996168ull }, { 0xf2d56790ab41c2a2ull, 0xfae27299423fb9c3ull },
+            { 0x97c560ba6b0919a5ull, 0xdccd879fc967d41aull }, { 0xbdb6b8e905cb600full, 0x5400e987bbc1c920ull },
+            { 0xed246723473e3813ull, 0x290123e9aab23b68ull }, { 0x9436c0760c86e30bull, 0xf9a0b6720aaf6521ull },
+            { 0xb94470938fa89bceull, 0xf808e40e8d5b3e69ull }, { 0xe7958cb87392c2c2ull, 0xb60b1d1230b20e04ull },
+            { 0x90bd77f3483bb9b9ull, 0xb1c6f22b5e6f48c2ull }, { 0xb4ecd5f01a4aa828ull, 0x1e38aeb6360b1af3ull },
+            { 0xe2280b6c20dd5232ull, 0x25c6da63c38de1b0ull }, { 0x8d590723948a535full, 0x579c487e5a38ad0eull },
+            { 0xb0af48ec79ace837ull, 0x2d835a9df0c6d851ull }, { 0xdcdb1b2798182244ull, 0xf8e431456cf88e65ull },
+            { 0x8a08f0f8bf0f156bull, 0x1b8e9ecb641b58ffull }, { 0xac8b2d36eed2dac5ull, 0xe272467e3d222f3full },
+            { 0xd7adf884aa879177ull, 0x5b0ed81dcc6abb0full }, { 0x86ccbb52ea94baeaull, 0x98e947129fc2b4e9ull },
+            { 0xa87fea27a539e9a5ull, 0x3f2398d747b36224ull }, { 0xd29fe4b18e88640eull, 0x8eec7f0d19a03aadull },
+            { 0x83a3eeeef9153e89ull, 0x1953cf68300424acull }, { 0xa48ceaaab75a8e2bull, 0x5fa8c3423c052dd7ull },
+            { 0xcdb02555653131b6ull, 0x3792f412cb06794dull }, { 0x808e17555f3ebf11ull, 0xe2bbd88bbee40bd0ull },
+            { 0xa0b19d2ab70e6ed6ull, 0x5b6aceaeae9d0ec4ull }, { 0xc8de047564d20a8bull, 0xf245825a5a445275ull },
+            { 0xfb158592be068d2eull, 0xeed6e2f0f0d56712ull }, { 0x9ced737bb6c4183dull, 0x55464dd69685606bull },
+            { 0xc428d05aa4751e4cull, 0xaa97e14c3c26b886ull }, { 0xf53304714d9265dfull, 0xd53dd99f4b3066a8ull },
+            { 0x993fe2c6d07b7fabull, 0xe546a8038efe4029ull }, { 0xbf8fdb78849a5f96ull, 0xde98520472bdd033ull },
+            { 0xef73d256a5c0f77cull, 0x963e66858f6d4440ull }, { 0x95a8637627989aadull, 0xdde7001379a44aa8ull },
+            { 0xbb127c53b17ec159ull, 0x5560c018580d5d52ull }, { 0xe9d71b689dde71afull, 0xaab8f01e6e10b4a6ull },
+            { 0x9226712162ab070dull, 0xcab3961304ca70e8ull }, { 0xb6b00d69bb55c8d1ull, 0x3d607b97c5fd0d22ull },
+            { 0xe45c10c42a2b3b05ull, 0x8cb89a7db77c506aull }, { 0x8eb98a7a9a5b04e3ull, 0x77f3608e92adb242ull },
+            { 0xb267ed1940f1c61cull, 0x55f038b237591ed3ull }, { 0xdf01e85f912e37a3ull, 0x6b6c46dec52f6688ull },
+            { 0x8b61313bbabce2c6ull, 0x2323ac4b3b3da015ull }, { 0xae397d8aa96c1b77ull, 0xabec975e0a0d081aull },
+            { 0xd9c7dced53c72255ull, 0x96e7bd358c904a21ull }, { 0x881cea14545c7575ull, 0x7e50d64177da2e54ull },
+            { 0xaa242499697392d2ull, 0xdde50bd1d5d0b9e9ull }, { 0xd4ad2dbfc3d07787ull, 0x955e4ec64b44e864ull },
+            { 0x84ec3c97da624ab4ull, 0xbd5af13bef0b113eull }, { 0xa6274bbdd0fadd61ull, 0xecb1ad8aeacdd58eull },
+            { 0xcfb11ead453994baull, 0x67de18eda5814af2ull }, { 0x81ceb32c4b43fcf4ull, 0x80eacf948770ced7ull },
+            { 0xa2425ff75e14fc31ull, 0xa1258379a94d028dull }, { 0xcad2f7f5359a3b3eull, 0x096ee45813a04330ull },
+            { 0xfd87b5f28300ca0dull, 0x8bca9d6e188853fcull }, { 0x9e74d1b791e07e48ull, 0x775ea264cf55347eull },
+            { 0xc612062576589ddaull, 0x95364afe032a819eull }, { 0xf79687aed3eec551ull, 0x3a83ddbd83f52205ull },
+            { 0x9abe14cd44753b52ull, 0xc4926a9672793543ull }, { 0xc16d9a0095928a27ull, 0x75b7053c0f178294ull },
+            { 0xf1c90080baf72cb1ull, 0x5324c68b12dd6339ull }, { 0x971da05074da7beeull, 0xd3f6fc16ebca5e04ull },
+            { 0xbce5086492111aeaull, 0x88f4bb1ca6bcf585ull }, { 0xec1e4a7db69561a5ull, 0x2b31e9e3d06c32e6ull },
+            { 0x9392ee8e921d5d07ull, 0x3aff322e62439fd0ull }, { 0xb877aa3236a4b449ull, 0x09befeb9fad487c3ull },
+            { 0xe69594bec44de15bull, 0x4c2ebe687989a9b4ull }, { 0x901d7cf73ab0acd9ull, 0x0f9d37014bf60a11ull },
+            { 0xb424dc35095cd80full, 0x538484c19ef38c95ull }, { 0xe12e13424bb40e13ull, 0x2865a5f206b06fbaull },
+            { 0x8cbccc096f5088cbull, 0xf93f87b7442e45d4ull }, { 0xafebff0bcb24aafeull, 0xf78f69a51539d749ull },
+            { 0xdbe6fecebdedd5beull, 0xb573440e5a884d1cull }, { 0x89705f4136b4a597ull, 0x31680a88f8953031ull },
+            { 0xabcc77118461cefcull, 0xfdc20d2b36ba7c3eull }, { 0xd6bf94d5e57a42bcull, 0x3d32907604691b4dull },
+            { 0x8637bd05af6c69b5ull, 0xa63f9a49c2c1b110ull }, { 0xa7c5ac471b478423ull, 0x0fcf80dc33721d54ull },
+            { 0xd1b71758e219652bull, 0xd3c36113404ea4a9ull }, { 0x83126e978d4fdf3bull, 0x645a1cac083126eaull },
+            { 0xa3d70a3d70a3d70aull, 0x3d70a3d70a3d70a4ull }, { 0xccccccccccccccccull, 0xcccccccccccccccdull },
+            { 0x8000000000000000ull, 0x0000000000000000ull }, { 0xa000000000000000ull, 0x0000000000000000ull },
+            { 0xc800000000000000ull, 0x0000000000000000ull }, { 0xfa00000000000000ull, 0x0000000000000000ull },
+            { 0x9c40000000000000ull, 0x0000000000000000ull }, { 0xc350000000000000ull, 0x0000000000000000ull },
+            { 0xf424000000000000ull, 0x0000000000000000ull }, { 0x9896800000000000ull, 0x0000000000000000ull },
+            { 0xbebc200000000000ull, 0x0000000000000000ull }, { 0xee6b280000000000ull, 0x0000000000000000ull },
+            { 0x9502f90000000000ull, 0x0000000000000000ull }, { 0xba43b74000000000ull, 0x0000000000000000ull },
+            { 0xe8d4a51000000000ull, 0x0000000000000000ull }, { 0x9184e72a00000000ull, 0x0000000000000000ull },
+            { 0xb5e620f480000000ull, 0x0000000000000000ull }, { 0xe35fa931a0000000ull, 0x0000000000000000ull },
+            { 0x8e1bc9bf04000000ull, 0x0000000000000000ull }, { 0xb1a2bc2ec5000000ull, 0x0000000000000000ull },
+            { 0xde0b6b3a76400000ull, 0x0000000000000000ull }, { 0x8ac7230489e80000ull, 0x0000000000000000ull },
+            { 0xad78ebc5ac620000ull, 0x0000000000000000ull }, { 0xd8d726b7177a8000ull, 0x0000000000000000ull },
+            { 0x878678326eac9000ull, 0x0000000000000000ull }, { 0xa968163f0a57b400ull, 0x0000000000000000ull },
+            { 0xd3c21bcecceda100ull, 0x0000000000000000ull }, { 0x84595161401484a0ull, 0x0000000000000000ull },
+            { 0xa56fa5b99019a5c8ull, 0x0000000000000000ull }, { 0xcecb8f27f4200f3aull, 0x0000000000000000ull },
+            { 0x813f3978f8940984ull, 0x4000000000000000ull }, { 0xa18f07d736b90be5ull, 0x5000000000000000ull },
+            { 0xc9f2c9cd04674edeull, 0xa400000000000000ull }, { 0xfc6f7c4045812296ull, 0x4d00000000000000ull },
+            { 0x9dc5ada82b70b59dull, 0xf020000000000000ull }, { 0xc5371912364ce305ull, 0x6c28000000000000ull },
+            { 0xf684df56c3e01bc6ull, 0xc732000000000000ull }, { 0x9a130b963a6c115cull, 0x3c7f400000000000ull },
+            { 0xc097ce7bc90715b3ull, 0x4b9f100000000000ull }, { 0xf0bdc21abb48db20ull, 0x1e86d40000000000ull },
+            { 0x96769950b50d88f4ull, 0x1314448000000000ull }, { 0xbc143fa4e250eb31ull, 0x17d955a000000000ull },
+            { 0xeb194f8e1ae525fdull, 0x5dcfab0800000000ull }, { 0x92efd1b8d0cf37beull, 0x5aa1cae500000000ull },
+            { 0xb7abc627050305adull, 0xf14a3d9e40000000ull }, { 0xe596b7b0c643c719ull, 0x6d9ccd05d0000000ull },
+            { 0x8f7e32ce7bea5c6full, 0xe4820023a2000000ull }, { 0xb35dbf821ae4f38bull, 0xdda2802c8a800000ull },
+            { 0xe0352f62a19e306eull, 0xd50b2037ad200000ull }, { 0x8c213d9da502de45ull, 0x4526f422cc340000ull },
+            { 0xaf298d050e4395d6ull, 0x9670b12b7f410000ull }, { 0xdaf3f04651d47b4cull, 0x3c0cdd765f114000ull },
+            { 0x88d8762bf324cd0full, 0xa5880a69fb6ac800ull }, { 0xab0e93b6efee0053ull, 0x8eea0d047a457a00ull },
+            { 0xd5d238a4abe98068ull, 0x72a4904598d6d880ull }, { 0x85a36366eb71f041ull, 0x47a6da2b7f864750ull },
+            { 0xa70c3c40a64e6c51ull, 0x999090b65f67d924ull }, { 0xd0cf4b50cfe20765ull, 0xfff4b4e3f741cf6dull },
+            { 0x82818f1281ed449full, 0xbff8f10e7a8921a4ull }, { 0xa321f2d7226895c7ull, 0xaff72d52192b6a0dull },
+            { 0xcbea6f8ceb02bb39ull, 0x9bf4f8a69f764490ull }, { 0xfee50b7025c36a08ull, 0x02f236d04753d5b4ull },
+            { 0x9f4f2726179a2245ull, 0x01d762422c946590ull }, { 0xc722f0ef9d80aad6ull, 0x424d3ad2b7b97ef5ull },
+            { 0xf8ebad2b84e0d58bull, 0xd2e0898765a7deb2ull }, { 0x9b934c3b330c8577ull, 0x63cc55f49f88eb2full },
+            { 0xc2781f49ffcfa6d5ull, 0x3cbf6b71c76b25fbull }, { 0xf316271c7fc3908aull, 0x8bef464e3945ef7aull },
+            { 0x97edd871cfda3a56ull, 0x97758bf0e3cbb5acull }, { 0xbde94e8e43d0c8ecull, 0x3d52eeed1cbea317ull },
+            { 0xed63a231d4c4fb27ull, 0x4ca7aaa863ee4bddull }, { 0x945e455f24fb1cf8ull, 0x8fe8caa93e74ef6aull },
+            { 0xb975d6b6ee39e436ull, 0xb3e2fd538e122b44ull }, { 0xe7d34c64a9c85d44ull, 0x60dbbca87196b616ull },
+            { 0x90e40fbeea1d3a4aull, 0xbc8955e946fe31cdull }, { 0xb51d13aea4a488ddull, 0x6babab6398bdbe41ull },
+            { 0xe264589a4dcdab14ull, 0xc696963c7eed2dd1ull }, { 0x8d7eb76070a08aecull, 0xfc1e1de5cf543ca2ull },
+            { 0xb0de65388cc8ada8ull, 0x3b25a55f43294bcbull }, { 0xdd15fe86affad912ull, 0x49ef0eb713f39ebeull },
+            { 0x8a2dbf142dfcc7abull, 0x6e3569326c784337ull }, { 0xacb92ed9397bf996ull, 0x49c2c37f07965404ull },
+            { 0xd7e77a8f87daf7fbull, 0xdc33745ec97be906ull }, { 0x86f0ac99b4e8dafdull, 0x69a028bb3ded71a3ull },
+            { 0xa8acd7c0222311bcull, 0xc40832ea0d68ce0cull }, { 0xd2d80db02aabd62bull, 0xf50a3fa490c30190ull },
+            { 0x83c7088e1aab65dbull, 0x792667c6da79e0faull }, { 0xa4b8cab1a1563f52ull, 0x577001b891185938ull },
+            { 0xcde6fd5e09abcf26ull, 0xed4c0226b55e6f86ull }, { 0x80b05e5ac60b6178ull, 0x544f8158315b05b4ull },
+            { 0xa0dc75f1778e39d6ull, 0x696361ae3db1c721ull }, { 0xc913936dd571c84cull, 0x03bc3a19cd1e38e9ull },
+            { 0xfb5878494ace3a5full, 0x04ab48a04065c723ull }, { 0x9d174b2dcec0e47bull, 0x62eb0d64283f9c76ull },
+            { 0xc45d1df942711d9aull, 0x3ba5d0bd324f8394ull }, { 0xf5746577930d6500ull, 0xca8f44ec7ee36479ull },
+            { 0x9968bf6abbe85f20ull, 0x7e998b13cf4e1ecbull }, { 0xbfc2ef456ae276e8ull, 0x9e3fedd8c321a67eull },
+            { 0xefb3ab16c59b14a2ull, 0xc5cfe94ef3ea101eull }, { 0x95d04aee3b80ece5ull, 0xbba1f1d158724a12ull },
+            { 0xbb445da9ca61281full, 0x2a8a6e45ae8edc97ull }, { 0xea1575143cf97226ull, 0xf52d09d71a3293bdull },
+            { 0x924d692ca61be758ull, 0x593c2626705f9c56ull }, { 0xb6e0c377cfa2e12eull, 0x6f8b2fb00c77836cull },
+            { 0xe498f455c38b997aull, 0x0b6dfb9c0f956447ull }, { 0x8edf98b59a373fecull, 0x4724bd4189bd5eacull },
+            { 0xb2977ee300c50fe7ull, 0x58edec91ec2cb657ull }, { 0xdf3d5e9bc0f653e1ull, 0x2f2967b66737e3edull },
+            { 0x8b865b215899f46cull, 0xbd79e0d20082ee74ull }, { 0xae67f1e9aec07187ull, 0xecd8590680a3aa11ull },
+            { 0xda01ee641a708de9ull, 0xe80e6f4820cc9495ull }, { 0x884134fe908658b2ull, 0x3109058d147fdcddull },
+            { 0xaa51823e34a7eedeull, 0xbd4b46f0599fd415ull }, { 0xd4e5e2cdc1d1ea96ull, 0x6c9e18ac7007c91aull },
+            { 0x850fadc09923329eull, 0x03e2cf6bc604ddb0ull }, { 0xa6539930bf6bff45ull, 0x84db8346b786151cull },
+            { 0xcfe87f7cef46ff16ull, 0xe612641865679a63ull }, { 0x81f14fae158c5f6eull, 0x4fcb7e8f3f60c07eull },
+            { 0xa26da3999aef7749ull, 0xe3be5e330f38f09dull }, { 0xcb090c8001ab551cull, 0x5cadf5bfd3072cc5ull },
+            { 0xfdcb4fa002162a63ull, 0x73d9732fc7c8f7f6ull }, { 0x9e9f11c4014dda7eull, 0x2867e7fddcdd9afaull },
+            { 0xc646d63501a1511dull, 0xb281e1fd541501b8ull }, { 0xf7d88bc24209a565ull, 0x1f225a7ca91a4226ull },
+            { 0x9ae757596946075full, 0x3375788de9b06958ull }, { 0xc1a12d2fc3978937ull, 0x0052d6b1641c83aeull },
+            { 0xf209787bb47d6b84ull, 0xc0678c5dbd23a49aull }, { 0x9745eb4d50ce6332ull, 0xf840b7ba963646e0ull },
+            { 0xbd176620a501fbffull, 0xb650e5a93bc3d898ull }, { 0xec5d3fa8ce427affull, 0xa3e51f138ab4cebeull },
+            { 0x93ba47c980e98cdfull, 0xc66f336c36b10137ull }, { 0xb8a8d9bbe123f017ull, 0xb80b0047445d4184ull },
+            { 0xe6d3102ad96cec1dull, 0xa60dc059157491e5ull }, { 0x9043ea1ac7e41392ull, 0x87c89837ad68db2full },
+            { 0xb454e4a179dd1877ull, 0x29babe4598c311fbull }, { 0xe16a1dc9d8545e94ull, 0xf4296dd6fef3d67aull },
+            { 0x8ce2529e2734bb1dull, 0x1899e4a65f58660cull }, { 0xb01ae745b101e9e4ull, 0x5ec05dcff72e7f8full },
+            { 0xdc21a1171d42645dull, 0x76707543f4fa1f73ull }, { 0x899504ae72497ebaull, 0x6a06494a791c53a8ull },
+            { 0xabfa45da0edbde69ull, 0x0487db9d17636892ull }, { 0xd6f8d7509292d603ull, 0x45a9d2845d3c42b6ull },
+            { 0x865b86925b9bc5c2ull, 0x0b8a2392ba45a9b2ull }, { 0xa7f26836f282b732ull, 0x8e6cac7768d7141eull },
+            { 0xd1ef0244af2364ffull, 0x3207d795430cd926ull }, { 0x8335616aed761f1full, 0x7f44e6bd49e807b8ull },
+            { 0xa402b9c5a8d3a6e7ull, 0x5f16206c9c6209a6ull }, { 0xcd036837130890a1ull, 0x36dba887c37a8c0full },
+            { 0x802221226be55a64ull, 0xc2494954da2c9789ull }, { 0xa02aa96b06deb0fdull, 0xf2db9baa10b7bd6cull },
+            { 0xc83553c5c8965d3dull, 0x6f92829494e5acc7ull }, { 0xfa42a8b73abbf48cull, 0xcb772339ba1f17f9ull },
+            { 0x9c69a97284b578d7ull, 0xff2a760414536efbull }, { 0xc38413cf25e2d70dull, 0xfef5138519684abaull },
+            { 0xf46518c2ef5b8cd1ull, 0x7eb258665fc25d69ull }, { 0x98bf2f79d5993802ull, 0xef2f773ffbd97a61ull },
+            { 0xbeeefb584aff8603ull, 0xaafb550ffacfd8faull }, { 0xeeaaba2e5dbf6784ull, 0x95ba2a53f983cf38ull },
+            { 0x952ab45cfa97a0b2ull, 0xdd945a747bf26183ull }, { 0xba756174393d88dfull, 0x94f971119aeef9e4ull },
+            { 0xe912b9d1478ceb17ull, 0x7a37cd5601aab85dull }, { 0x91abb422ccb812eeull, 0xac62e055c10ab33aull },
+            { 0xb616a12b7fe617aaull, 0x577b986b314d6009ull }, { 0xe39c49765fdf9d94ull, 0xed5a7e85fda0b80bull },
+            { 0x8e41ade9fbebc27dull, 0x14588f13be847307ull }, { 0xb1d219647ae6b31cull, 0x596eb2d8ae258fc8ull },
+            { 0xde469fbd99a05fe3ull, 0x6fca5f8ed9aef3bbull }, { 0x8aec23d680043beeull, 0x25de7bb9480d5854ull },
+            { 0xada72ccc20054ae9ull, 0xaf561aa79a10ae6aull }, { 0xd910f7ff28069da4ull, 0x1b2ba1518094da04ull },
+            { 0x87aa9aff79042286ull, 0x90fb44d2f05d0842ull }, { 0xa99541bf57452b28ull, 0x353a1607ac744a53ull },
+            { 0xd3fa922f2d1675f2ull, 0x42889b8997915ce8ull }, { 0x847c9b5d7c2e09b7ull, 0x69956135febada11ull },
+            { 0xa59bc234db398c25ull, 0x43fab9837e699095ull }, { 0xcf02b2c21207ef2eull, 0x94f967e45e03f4bbull },
+            { 0x8161afb94b44f57dull, 0x1d1be0eebac278f5ull }, { 0xa1ba1ba79e1632dcull, 0x6462d92a69731732ull },
+            { 0xca28a291859bbf93ull, 0x7d7b8f7503cfdcfeull }, { 0xfcb2cb35e702af78ull, 0x5cda735244c3d43eull },
+            { 0x9defbf01b061adabull, 0x3a0888136afa64a7ull }, { 0xc56baec21c7a1916ull, 0x088aaa1845b8fdd0ull },
+            { 0xf6c69a72a3989f5bull, 0x8aad549e57273d45ull }, { 0x9a3c2087a63f6399ull, 0x36ac54e2f678864bull },
+            { 0xc0cb28a98fcf3c7full, 0x84576a1bb416a7ddull }, { 0xf0fdf2d3f3c30b9full, 0x656d44a2a11c51d5ull },
+            { 0x969eb7c47859e743ull, 0x9f644ae5a4b1b325ull }, { 0xbc4665b596706114ull, 0x873d5d9f0dde1feeull },
+            { 0xeb57ff22fc0c7959ull, 0xa90cb506d155a7eaull }, { 0x9316ff75dd87cbd8ull, 0x09a7f12442d588f2ull },
+            { 0xb7dcbf5354e9beceull, 0x0c11ed6d538aeb2full }, { 0xe5d3ef282a242e81ull, 0x8f1668c8a86da5faull },
+            { 0x8fa475791a569d10ull, 0xf96e017d694487bcull }, { 0xb38d92d760ec4455ull, 0x37c981dcc395a9acull },
+            { 0xe070f78d3927556aull, 0x85bbe253f47b1417ull }, { 0x8c469ab843b89562ull, 0x93956d7478ccec8eull },
+            { 0xaf58416654a6babbull, 0x387ac8d1970027b2ull }, { 0xdb2e51bfe9d0696aull, 0x06997b05fcc0319eull },
+            { 0x88fcf317f22241e2ull, 0x441fece3bdf81f03ull }, { 0xab3c2fddeeaad25aull, 0xd527e81cad7626c3ull },
+            { 0xd60b3bd56a5586f1ull, 0x8a71e223d8d3b074ull }, { 0x85c7056562757456ull, 0xf6872d5667844e49ull },
+            { 0xa738c6bebb12d16cull, 0xb428f8ac016561dbull }, { 0xd106f86e69d785c7ull, 0xe13336d701beba52ull },
+            { 0x82a45b450226b39cull, 0xecc0024661173473ull }, { 0xa34d721642b06084ull, 0x27f002d7f95d0190ull },
+            { 0xcc20ce9bd35c78a5ull, 0x31ec038df7b441f4ull }, { 0xff290242c83396ceull, 0x7e67047175a15271ull },
+            { 0x9f79a169bd203e41ull, 0x0f0062c6e984d386ull }, { 0xc75809c42c684dd1ull, 0x52c07b78a3e60868ull },
+            { 0xf92e0c3537826145ull, 0xa7709a56ccdf8a82ull }, { 0x9bbcc7a142b17ccbull, 0x88a66076400bb691ull },
+            { 0xc2abf989935ddbfeull, 0x6acff893d00ea435ull }, { 0xf356f7ebf83552feull, 0x0583f6b8c4124d43ull },
+            { 0x98165af37b2153deull, 0xc3727a337a8b704aull }, { 0xbe1bf1b059e9a8d6ull, 0x744f18c0592e4c5cull },
+            { 0xeda2ee1c7064130cull, 0x1162def06f79df73ull }, { 0x9485d4d1c63e8be7ull, 0x8addcb5645ac2ba8ull },
+            { 0xb9a74a0637ce2ee1ull, 0x6d953e2bd7173692ull }, { 0xe8111c87c5c1ba99ull, 0xc8fa8db6ccdd0437ull },
+            { 0x910ab1d4db9914a0ull, 0x1d9c9892400a22a2ull }, { 0xb54d5e4a127f59c8ull, 0x2503beb6d00cab4bull },
+            { 0xe2a0b5dc971f303aull, 0x2e44ae64840fd61dull }, { 0x8da471a9de737e24ull, 0x5ceaecfed289e5d2ull },
+            { 0xb10d8e1456105dadull, 0x7425a83e872c5f47ull }, { 0xdd50f1996b947518ull, 0xd12f124e28f77719ull },
+            { 0x8a5296ffe33cc92full, 0x82bd6b70d99aaa6full }, { 0xace73cbfdc0bfb7bull, 0x636cc64d1001550bull },
+            { 0xd8210befd30efa5aull, 0x3c47f7e05401aa4eull }, { 0x8714a775e3e95c78ull, 0x65acfaec34810a71ull },
+            { 0xa8d9d1535ce3b396ull, 0x7f1839a741a14d0dull }, { 0xd31045a8341ca07cull, 0x1ede48111209a050ull },
+            { 0x83ea2b892091e44dull, 0x934aed0aab460432ull }, { 0xa4e4b66b68b65d60ull, 0xf81da84d5617853full },
+            { 0xce1de40642e3f4b9ull, 0x36251260ab9d668eull }, { 0x80d2ae83e9ce78f3ull, 0xc1d72b7c6b426019ull },
+            { 0xa1075a24e4421730ull, 0xb24cf65b8612f81full }, { 0xc94930ae1d529cfcull, 0xdee033f26797b627ull },
+            { 0xfb9b7cd9a4a7443cull, 0x169840ef017da3b1ull }, { 0x9d412e0806e88aa5ull, 0x8e1f289560ee864eull },
+            { 0xc491798a08a2ad4eull, 0xf1a6f2bab92a27e2ull }, { 0xf5b5d7ec8acb58a2ull, 0xae10af696774b1dbull },
+            { 0x9991a6f3d6bf1765ull, 0xacca6da1e0a8ef29ull }, { 0xbff610b0cc6edd3full, 0x17fd090a58d32af3ull },
+            { 0xeff394dcff8a948eull, 0xddfc4b4cef07f5b0ull }, { 0x95f83d0a1fb69cd9ull, 0x4abdaf101564f98eull },
+            { 0xbb764c4ca7a4440full, 0x9d6d1ad41abe37f1ull }, { 0xea53df5fd18d5513ull, 0x84c86189216dc5edull },
+            { 0x92746b9be2f8552cull, 0x32fd3cf5b4e49bb4ull }, { 0xb7118682dbb66a77ull, 0x3fbc8c33221dc2a1ull },
+            { 0xe4d5e82392a40515ull, 0x0fabaf3feaa5334aull }, { 0x8f05b1163ba6832dull, 0x29cb4d87f2a7400eull },
+            { 0xb2c71d5bca9023f8ull, 0x743e20e9ef511012ull }, { 0xdf78e4b2bd342cf6ull, 0x914da9246b255416ull },
+            { 0x8bab8eefb6409c1aull, 0x1ad089b6c2f7548eull }, { 0xae9672aba3d0c320ull, 0xa184ac2473b529b1ull },
+            { 0xda3c0f568cc4f3e8ull, 0xc9e5d72d90a2741eull }, { 0x8865899617fb1871ull, 0x7e2fa67c7a658892ull },
+            { 0xaa7eebfb9df9de8dull, 0xddbb901b98feeab7ull }, { 0xd51ea6fa85785631ull, 0x552a74227f3ea565ull },
+            { 0x8533285c936b35deull, 0xd53a88958f87275full }, { 0xa67ff273b8460356ull, 0x8a892abaf368f137ull },
+            { 0xd01fef10a657842cull, 0x2d2b7569b0432d85ull }, { 0x8213f56a67f6b29bull, 0x9c3b29620e29fc73ull },
+            { 0xa298f2c501f45f42ull, 0x8349f3ba91b47b8full }, { 0xcb3f2f7642717713ull, 0x241c70a936219a73ull },
+            { 0xfe0efb53d30dd4d7ull, 0xed238cd383aa0110ull }, { 0x9ec95d1463e8a506ull, 0xf4363804324a40aaull },
+            { 0xc67bb4597ce2ce48ull, 0xb143c6053edcd0d5ull }, { 0xf81aa16fdc1b81daull, 0xdd94b7868e94050aull },
+            { 0x9b10a4e5e9913128ull, 0xca7cf2b4191c8326ull }, { 0xc1d4ce1f63f57d72ull, 0xfd1c2f611f63a3f0ull },
+            { 0xf24a01a73cf2dccfull, 0xbc633b39673c8cecull }, { 0x976e41088617ca01ull, 0xd5be0503e085d813ull },
+            { 0xbd49d14aa79dbc82ull, 0x4b2d8644d8a74e18ull }, { 0xec9c459d51852ba2ull, 0xddf8e7d60ed1219eull },
+            { 0x93e1ab8252f33b45ull, 0xcabb90e5c942b503ull }, { 0xb8da1662e7b00a17ull, 0x3d6a751f3b936243ull },
+            { 0xe7109bfba19c0c9dull, 0x0cc512670a783ad4ull }, { 0x906a617d450187e2ull, 0x27fb2b80668b24c5ull },
+            { 0xb484f9dc9641e9daull, 0xb1f9f660802dedf6ull }, { 0xe1a63853bbd26451ull, 0x5e7873f8a0396973ull },
+            { 0x8d07e33455637eb2ull, 0xdb0b487b6423e1e8ull }, { 0xb049dc016abc5e5full, 0x91ce1a9a3d2cda62ull },
+            { 0xdc5c5301c56b75f7ull, 0x7641a140cc7810fbull }, { 0x89b9b3e11b6329baull, 0xa9e904c87fcb0a9dull },
+            { 0xac2820d9623bf429ull, 0x546345fa9fbdcd44ull }, { 0xd732290fbacaf133ull, 0xa97c177947ad4095ull },
+            { 0x867f59a9d4bed6c0ull, 0x49ed8eabcccc485dull }, { 0xa81f301449ee8c70ull, 0x5c68f256bfff5a74ull },
+            { 0xd226fc195c6a2f8cull, 0x73832eec6fff3111ull }, { 0x83585d8fd9c25db7ull, 0xc831fd53c5ff7eabull },
+            { 0xa42e74f3d032f525ull, 0xba3e7ca8b77f5e55ull }, { 0xcd3a1230c43fb26full, 0x28ce1bd2e55f35ebull },
+            { 0x80444b5e7aa7cf85ull, 0x7980d163cf5b81b3ull }, { 0xa0555e361951c366ull, 0xd7e105bcc332621full },
+            { 0xc86ab5c39fa63440ull, 0x8dd9472bf3fefaa7ull }, { 0xfa856334878fc150ull, 0xb14f98f6f0feb951ull },
+            { 0x9c935e00d4b9d8d2ull, 0x6ed1bf9a569f33d3ull }, { 0xc3b8358109e84f07ull, 0x0a862f80ec4700c8ull },
+            { 0xf4a642e14c6262c8ull, 0xcd27bb612758c0faull }, { 0x98e7e9cccfbd7dbdull, 0x8038d51cb897789cull },
+            { 0xbf21e44003acdd2cull, 0xe0470a63e6bd56c3ull }, { 0xeeea5d5004981478ull, 0x1858ccfce06cac74ull },
+            { 0x95527a5202df0ccbull, 0x0f37801e0c43ebc8ull }, { 0xbaa718e68396cffdull, 0xd30560258f54e6baull },
+            { 0xe950df20247c83fdull, 0x47c6b82ef32a2069ull }, { 0x91d28b7416cdd27eull, 0x4cdc331d57fa5441ull },
+            { 0xb6472e511c81471dull, 0xe0133fe4adf8e952ull }, { 0xe3d8f9e563a198e5ull, 0x58180fddd97723a6ull },
+            { 0x8e679c2f5e44ff8full, 0x570f09eaa7ea7648ull }
+    };
+
+    // w * 10^q rounded to the nearest double, false when the 128 bit product cannot decide the rounding
+    inline bool EiselLemire(u64 w, s64 q, double& result) noexcept
+    {
+        if (w == 0 || q < PowerOfFiveMin)
         {
-            return type == Type::Null;
+            result = 0.0;
+            return true;
         }
-
-        void SetNull() noexcept
+        if (q > PowerOfFiveMax)
         {
-            SetInvalid();
-            type = Type::Null;
+            result = std::numeric_limits<double>::infinity();
+            return true;
         }
 
-        // Bool
+        const int leadingZeros = std::countl_zero(w);
+        w <<= leadingZeros;
 
-        Value(bool v) noexcept
+        // 55 significant bits are needed, the low part of the power only matters when they are all ones
+        const PowerOfFive& power = PowersOfFive[q - PowerOfFiveMin];
+        u64 high = 0;
+        u64 low = Multiply128(w, power.High, high);
+        if ((high & 0x1FF) == 0x1FF)
         {
-            SetBool(v);
+            u64 secondHigh = 0;
+            Multiply128(w, power.Low, secondHigh);
+            low += secondHigh;
+            if (secondHigh > low)
+                ++high;
         }
+        if (low == ~0ull && (q < -27 || q > 55))
+            return false;
 
-        Value& operator=(const bool& v) noexcept
+        const int upperBit = (int)(high >> 63);
+        u64 mantissa = high >> (upperBit + 9);
+        // floor(log2(10^q)) + 63 + the binary exponent bias
+        s64 power2 = ((217706 * q) >> 16) + 63 + upperBit - leadingZeros + 1023;
+
+        if (power2 <= 0)
         {
-            SetBool(v);
-            return *this;
+            // subnormal
+            if (-power2 + 1 >= 64)
+            {
+                result = 0.0;
+                return true;
+            }
+            mantissa >>= -power2 + 1;
+            mantissa += mantissa & 1;
+            mantissa >>= 1;
+            power2 = mantissa < (1ull << 52) ? 0 : 1;
+            result = std::bit_cast<double>(mantissa | ((u64)power2 << 52));
+            return true;
         }
 
-        bool IsBool() const noexcept
+        // exactly halfway between two doubles: round to even
+        if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << (upperBit + 9)) == high)
+            mantissa &= ~1ull;
+
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        if (mantissa >= (2ull << 52))
         {
-            return type == Type::Bool;
+            mantissa = 1ull << 52;
+            ++power2;
         }
+        mantissa &= ~(1ull << 52);
 
-        void SetBool(bool value) noexcept
+        if (power2 >= 0x7FF)
         {
-            SetInvalid();
-            type = Type::Bool;
-            AsBool() = value;
+            result = std::numeric_limits<double>::infinity();
+            return true;
         }
+        result = std::bit_cast<double>(mantissa | ((u64)power2 << 52));
+        return true;
+    }
 
-        bool& AsBool() noexcept
+    inline bool IsDigit(string_char c) noexcept
+    {
+        return c >= EJSON_TEXT('0') && c <= EJSON_TEXT('9');
+    }
+
+    // 8 characters as little endian bytes
+    inline u64 LoadEightBytes(const char* p) noexcept
+    {
+        u64 bytes = 0;
+        if constexpr (std::endian::native == std::endian::little)
         {
-            EJSON_ASSERT(type == Type::Bool, "expected type: bool");
-            return *(bool*)buffer;
+            std::memcpy(&bytes, p, 8);
         }
-
-        const bool& AsBool() const noexcept
+        else
         {
-            return const_cast<Value*>(this)->AsBool();
+            for (int i = 0; i < 8; ++i)
+                bytes |= (u64)(unsigned char)p[i] << (i * 8);
         }
+        return bytes;
+    }
 
-        // Number
-
-        Value(s8 v) noexcept { SetNumber(v); }
-        Value& operator=(s8 v) noexcept { SetNumber(v); return *this; }
-        Value(s16 v) noexcept { SetNumber(v); }
-        Value& operator=(s16 v) noexcept { SetNumber(v); return *this; }
-        Value(s32 v) noexcept { SetNumber(v); }
-        Value& operator=(s32 v) noexcept { SetNumber(v); return *this; }
-        Value(s64 v) noexcept { SetNumber((number)v); }
-        Value& operator=(s64 v) noexcept { SetNumber((number)v); return *this; }
-
-        Value(u8 v) noexcept { SetNumber(v); }
-        Value& operator=(u8 v) noexcept { SetNumber(v); return *this; }
-        Value(u16 v) noexcept { SetNumber(v); }
-        Value& operator=(u16 v) noexcept { SetNumber(v); return *this; }
-        Value(u32 v) noexcept { SetNumber(v); }
-        Value& operator=(u32 v) noexcept { SetNumber(v); return *this; }
-        Value(u64 v) noexcept { SetNumber((number)v); }
-        Value& operator=(u64 v) noexcept { SetNumber((number)v); return *this; }
+    inline bool IsEightDigits(u64 bytes) noexcept
+    {
+        return (((bytes + 0x4646464646464646ull) | (bytes - 0x3030303030303030ull)) & 0x8080808080808080ull) == 0;
+    }
 
-        Value(f32 v) noexcept { SetNumber(v); }
-        Value& operator=(f32 v) noexcept { SetNumber(v); return *this; }
-        Value(f64 v) noexcept { SetNumber((number)v); }
-        Value& operator=(f64 v) noexcept { SetNumber((number)v); return *this; }
+    // SWAR: pairs of digits, then pairs of pairs, in three multiplications
+    inline u32 ParseEightDigits(u64 bytes) noexcept
+    {
+        constexpr u64 mask = 0x000000FF000000FFull;
+        constexpr u64 multiplier1 = 100 + (1000000ull << 32);
+        constexpr u64 multiplier2 = 1 + (10000ull << 32);
+        bytes -= 0x3030303030303030ull;
+        bytes = (bytes * 10) + (bytes >> 8);
+        return (u32)((((bytes & mask) * multiplier1) + (((bytes >> 16) & mask) * multiplier2)) >> 32);
+    }
 
-        bool IsNumber() const noexcept
+    // accumulate the digits of [p, end) in mantissa, returns the first character that is not a digit
+    // (8 at a time for char, packing wide characters to bytes costs more than it saves)
+    inline const string_char* ParseDigits(const string_char* p, const string_char* end, u64& mantissa) noexcept
+    {
+        if constexpr (sizeof(string_char) == 1)
         {
-            return type == Type::Number;
+            while (end - p >= 8)
+            {
+                const u64 bytes = LoadEightBytes((const char*)p);
+                if (!IsEightDigits(bytes))
+                    break;
+                mantissa = mantissa * 100000000 + ParseEightDigits(bytes);
+                p += 8;
+            }
         }
+        for (; p != end && IsDigit(*p); ++p)
+            mantissa = mantissa * 10 + (u64)(*p - EJSON_TEXT('0'));
+        return p;
+    }
 
-        void SetNumber(number value) noexcept
+    // correctly rounded conversion for inputs the fast paths cannot decide
+    inline double ParseNumberSlow(string_view str) noexcept
+    {
+        char buffer[64] = {};
+        c_string large;
+        char* chars = buffer;
+        if (StringSize(str) > sizeof(buffer))
         {
-            SetInvalid();
-            type = Type::Number;
-            static_assert(sizeof(number) <= ValueSize);
-            static_assert(alignof(number) <= ValueAlign);
-            AsNumber() = value;
+            large.resize(StringSize(str));
+            chars = large.data();
         }
-
-        number& AsNumber() noexcept
-        {
-            EJSON_ASSERT(type == Type::Number, "expected type: number");
-            return *(number*)buffer;
+        // already validated: digits, sign, '.' and exponent only
+        for (size_t i = 0; i < StringSize(str); ++i)
+            chars[i] = (char)str[i];
+
+        double result = 0.0;
+        const std::from_chars_result parsed = std::from_chars(chars, chars + StringSize(str), result);
+        if (parsed.ec == std::errc::result_out_of_range)
+        {
+            // too small or too large, the exponent sign tells which
+            const char* exponent = std::find_if(chars, chars + StringSize(str), [](char c) { return c == 'e' || c == 'E'; });
+            const bool tiny = exponent != chars + StringSize(str) && exponent[1] == '-';
+            result = tiny ? 0.0 : std::numeric_limits<double>::infinity();
+            if (chars[0] == '-')
+                result = -result;
         }
+        return result;
+    }
 
-        const number& AsNumber() const noexcept
-        {
-            return const_cast<Value*>(this)->AsNumber();
-        }
+    // Text is a number kept as written, Value converts it on access
+    enum class NumberType : std::uint8_t
+    {
+        Float,
+        Int64,
+        UInt64,
+        Text
+    };
 
-        // String
+    // converted number: integers without fraction or exponent that fit 64 bits are also given exactly in Int64
+    // (UInt64 above the s64 range), Value is always set. Text is only valid during the call
+    struct NumberToken
+    {
+        string_view Text;
+        number Value = 0.0;
+        NumberType Type = NumberType::Float;
+        s64 Int64 = 0;
+        u64 UInt64 = 0;
+    };
 
-        Value(const string& str) noexcept
+    // number at the start of [begin, end): [-]digits[.digits][(e|E)[+|-]digits], the exponent only if EXPONENT.
+    // Returns the character following it, nullptr if there is no digit before the '.' or after the 'e'
+    template<bool EXPONENT = true>
+    inline const string_char* ParseNumberPrefix(const string_char* begin, const string_char* end, NumberToken& token) noexcept
+    {
+        static constexpr double powersOfTen[] =
         {
-            SetString(str);
-        }
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
 
-        Value(const string_char* str) noexcept
-        {
-            SetString(str);
-        }
+        token.Value = 0.0;
+        token.Type = NumberType::Float;
+        token.Int64 = 0;
+        token.UInt64 = 0;
+        const string_char* p = begin;
+
+        const bool negative = p != end && *p == EJSON_TEXT('-');
+        if (negative)
+            ++p;
+
+        const string_char* integerBegin = p;
+        u64 mantissa = 0;
+        p = ParseDigits(p, end, mantissa);
+        const string_char* integerEnd = p;
+        if (integerEnd == integerBegin)
+            return nullptr;
 
-        Value& operator=(const string& str) noexcept
+        const string_char* fractionBegin = p;
+        if (p != end && *p == EJSON_TEXT('.'))
         {
-            SetString(str);
-            return *this;
+            fractionBegin = ++p;
+            p = ParseDigits(p, end, mantissa);
         }
+        const s64 fractionDigits = p - fractionBegin;
 
-        Value& operator=(const string_char* str) noexcept
+        s64 exponent = 0;
+        if (EXPONENT && p != end && (*p == EJSON_TEXT('e') || *p == EJSON_TEXT('E')))
         {
-            SetString(string(str));
-            return *this;
+            ++p;
+            bool exponentNegative = false;
+            if (p != end && (*p == EJSON_TEXT('+') || *p == EJSON_TEXT('-')))
+            {
+                exponentNegative = *p == EJSON_TEXT('-');
+                ++p;
+            }
+            if (p == end || !IsDigit(*p))
+                return nullptr;
+            for (; p != end && IsDigit(*p); ++p)
+            {
+                // beyond any double, keep it from overflowing
+                if (exponent < 0x10000)
+                    exponent = exponent * 10 + (s64)(*p - EJSON_TEXT('0'));
+            }
+            if (exponentNegative)
+                exponent = -exponent;
         }
 
-        bool IsString() const noexcept
+        // integer: exact when it fits 64 bits, "-0" stays a floating point negative zero
+        if (p == integerEnd)
         {
-            return type == Type::String;
-        }
-
-        void SetString(const string& value) noexcept
-        {
-            SetInvalid();
-            type = Type::String;
-            new (buffer) string(value);
+            u64 integer = mantissa;
+            bool fits = integerEnd - integerBegin <= 19;
+            if (!fits)
+            {
+                fits = true;
+                integer = 0;
+                for (const string_char* digit = integerBegin; digit != integerEnd && fits; ++digit)
+                {
+                    const u64 value = (u64)(*digit - EJSON_TEXT('0'));
+                    fits = integer <= (std::numeric_limits<u64>::max() - value) / 10;
+                    integer = integer * 10 + value;
+                }
+            }
+            if (fits && !negative)
+            {
+                if (integer <= (u64)std::numeric_limits<s64>::max())
+                {
+                    token.Type = NumberType::Int64;
+                    token.Int64 = (s64)integer;
+                }
+                else
+                {
+                    token.Type = NumberType::UInt64;
+                    token.UInt64 = integer;
+                }
+            }
+            else if (fits && integer != 0 && integer <= (u64)std::numeric_limits<s64>::max() + 1)
+            {
+                token.Type = NumberType::Int64;
+                token.Int64 = (s64)(0 - integer);
+            }
         }
 
-        void SetString(string&& value) noexcept
+        s64 q = exponent - fractionDigits;
+
+        // more than 19 significant digits do not fit the mantissa: keep the first 19, the value is then between
+        // mantissa and mantissa + 1
+        bool truncated = false;
+        if ((integerEnd - integerBegin) + fractionDigits > 19)
         {
-            SetInvalid();
-            type = Type::String;
-            static_assert(sizeof(string) <= ValueSize);
-            static_assert(alignof(string) <= ValueAlign);
-            new (buffer) string(EJSON_FORWARD<string>(value));
+            const string_char* significant = integerBegin;
+            s64 digits = (integerEnd - integerBegin) + fractionDigits;
+            for (; significant != p && (*significant == EJSON_TEXT('0') || *significant == EJSON_TEXT('.')); ++significant)
+            {
+                if (*significant == EJSON_TEXT('0'))
+                    --digits;
+            }
+            if (digits > 19)
+            {
+                truncated = true;
+                mantissa = 0;
+                s64 taken = 0;
+                const string_char* digit = significant;
+                for (; digit < integerEnd && taken < 19; ++digit, ++taken)
+                    mantissa = mantissa * 10 + (u64)(*digit - EJSON_TEXT('0'));
+                if (taken == 19)
+                {
+                    q = exponent + (integerEnd - digit);
+                }
+                else
+                {
+                    digit = std::max(digit, fractionBegin);
+                    for (; taken < 19; ++digit, ++taken)
+                        mantissa = mantissa * 10 + (u64)(*digit - EJSON_TEXT('0'));
+                    q = exponent - (digit - fractionBegin);
+                }
+            }
         }
 
-        string& AsString() noexcept
+        double value = 0.0;
+        if (!truncated && q >= -22 && q <= 22 && mantissa <= (1ull << 53))
         {
-            EJSON_ASSERT(type == Type::String, "expected type: string");
-            return *(string*)buffer;
+            // both exact, a single rounding
+            value = (double)mantissa;
+            value = q < 0 ? value / powersOfTen[-q] : value * powersOfTen[q];
         }
-
-        const string& AsString() const noexcept
+        else
         {
-            return const_cast<Value*>(this)->AsString();
+            double upper = 0.0;
+            if (!EiselLemire(mantissa, q, value) || (truncated && (!EiselLemire(mantissa + 1, q, upper) || upper != value)))
+            {
+                token.Value = (number)ParseNumberSlow(string_view(begin, p - begin));
+                return p;
+            }
         }
 
-        // Array
+        token.Value = (number)(negative ? -value : value);
+        return p;
+    }
 
-        Value(const vector<Value>& value) noexcept
-        {
-            SetArray(value);
-        }
+    inline bool ParseNumber(string_view str, NumberToken& token) noexcept
+    {
+        const string_char* end = str.data() + StringSize(str);
+        const string_char* parsed = ParseNumberPrefix(str.data(), end, token);
+        token.Text = str;
+        return parsed != nullptr && parsed == end;
+    }
 
-        Value& operator=(const vector<Value>& value) noexcept
-        {
-            SetArray(value);
-            return *this;
-        }
+    inline bool ParseNumber(string_view str, number& result) noexcept
+    {
+        NumberToken token;
+        const bool parsed = ParseNumber(str, token);
+        result = token.Value;
+        return parsed;
+    }
 
-        bool IsArray() const noexcept
-        {
-            return type == Type::Array;
+    // decimal digits of value written backward from end, returns the first one
+    inline string_char* FormatInteger(u64 value, string_char* end) noexcept
+    {
+        static constexpr char digitPairs[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        while (value >= 100)
+        {
+            const size_t pair = (size_t)(value % 100) * 2;
+            value /= 100;
+            *--end = (string_char)digitPairs[pair + 1];
+            *--end = (string_char)digitPairs[pair];
         }
-
-        void SetArray(const vector<Value>& value) noexcept
+        if (value >= 10)
         {
-            SetInvalid();
-            type = Type::Array;
-            new (buffer) vector<Value>(value);
+            *--end = (string_char)digitPairs[value * 2 + 1];
+            *--end = (string_char)digitPairs[value * 2];
         }
-
-        void SetArray(vector<Value>&& value) noexcept
+        else
         {
-            SetInvalid();
-            type = Type::Array;
-            static_assert(sizeof(vector<Value>) <= ValueSize);
-            static_assert(alignof(vector<Value>) <= ValueAlign);
-            new (buffer) vector<Value>(EJSON_FORWARD<vector<Value>>(value));
+            *--end = (string_char)(EJSON_TEXT('0') + value);
         }
+        return end;
+    }
 
-        vector<Value>& AsArray() noexcept
+    // buffer size for FormatNumber
+    constexpr size_t FormatNumberSize = 32;
+
+    // shortest text that reads back to the same number, written from buffer, returns its end. Integral values
+    // below 2^53 are written as integers, the others with std::to_chars (shortest round trip, no allocation or
+    // locale): 0.1, 1e+22, 5e-324
+    inline string_char* FormatNumber(number value, string_char* buffer) noexcept
+    {
+        if (std::fabs(value) < 9007199254740992.0)
         {
-            EJSON_ASSERT(type == Type::Array, "expected type: array");
-            return *(vector<Value>*)buffer;
+            const s64 integer = (s64)value;
+            if ((number)integer == value && !(integer == 0 && std::signbit(value)))
+            {
+                string_char digits[20];
+                string_char* end = digits + 20;
+                string_char* begin = FormatInteger(integer < 0 ? 0 - (u64)integer : (u64)integer, end);
+                if (integer < 0)
+                    *buffer++ = EJSON_TEXT('-');
+                return std::copy(begin, end, buffer);
+            }
         }
 
-        const vector<Value>& AsArray() const noexcept
+        if constexpr (sizeof(string_char) == 1)
         {
-            return const_cast<Value*>(this)->AsArray();
+            return (string_char*)std::to_chars((char*)buffer, (char*)buffer + FormatNumberSize, value).ptr;
         }
-
-        Value& operator[](size_t index) noexcept
+        else
         {
-            static Value invalid;
-            if (!IsArray())
-                SetArray({});
-            vector<Value>& array = AsArray();
-            while(VectorSize(array) <= index )
-                VectorEmplace(array, {});
-
-            return AsArray()[index];
+            char chars[FormatNumberSize];
+            const char* end = std::to_chars(chars, chars + FormatNumberSize, value).ptr;
+            return std::copy((const char*)chars, end, buffer);
         }
+    }
 
-        // Object
+#if !EJSON_CONFIG_FILE
+    // default of the config hook, ejson_config.h defines its own
+    inline void WriteNumber(number value, string& output) noexcept
+    {
+        string_char text[FormatNumberSize];
+        output.assign(text, FormatNumber(value, text));
+    }
+#endif
 
-        Value(const map<string, Value>& value) noexcept
+    class Value
+    {
+    public:
+
+        enum class Type : std::uint8_t
         {
-            SetObject(value);
-        }
+            Invalid,
+            Null,
+            Bool,
+            Number,
+            String,
+            Array,
+            Object
+        };
 
-        Value& operator=(const map<string, Value>& value) noexcept
+        Value() = default;
+
+        Value(const Value& value) noexcept
         {
-            SetObject(value);
-            return *this;
+            Set(value);
         }
 
-        bool IsObject() const noexcept
+        Value(Value&& value) noexcept
         {
-            return type == Type::Object;
+            Set(EJSON_FORWARD<Value>(value));
         }
 
-        void SetObject(const map<string, Value>& value) noexcept
+        ~Value() noexcept
         {
             SetInvalid();
-            type = Type::Object;
-            static_assert(sizeof(map<string, Value>) <= ValueSize);
-            static_assert(alignof(map<string, Value>) <= ValueAlign);
-            new (buffer) map<string, Value>(value);
         }
 
-        void SetObject(map<string, Value>&& value) noexcept
+        Value& operator=(const Value& other) noexcept
         {
-            SetInvalid();
-            type = Type::Object;
-            static_assert(sizeof(map<string, Value>) <= ValueSize);
-            static_assert(alignof(map<string, Value>) <= ValueAlign);
-            new (buffer) map<string, Value>(EJSON_FORWARD<map<string, Value>>(value));
+            if (this != &other)
+            {
+                Set(other);
+            }
+            return *this;
         }
 
-        map<string, Value>& AsObject() noexcept
+        Type GetType() const noexcept
         {
-            EJSON_ASSERT(type == Type::Object, "expected type: object");
-            return *(map<string, Value>*)buffer;
+            return type;
         }
 
-        const map<string, Value>& AsObject() const noexcept
+        // Value
+        void Set(const Value& other) noexcept
         {
-            return const_cast<Value*>(this)->AsObject();
+            switch (other.type)
+            {
+                case Type::Invalid:
+                    SetInvalid();
+                    break;
+                case Type::Null:
+                    SetNull();
+                    break;
+                case Type::Bool:
+                    SetBool(other.AsBool());
+                    break;
+                case Type::Number:
+                    CopyNumber(other);
+                    break;
+                case Type::String:
+                    SetString(other.AsStringView());
+                    break;
+                case Type::Array:
+                    SetArray(other.AsArray());
+                    break;
+                case Type::Object:
+                    SetObject(other.AsObject());
+                    break;
+            }
         }
 
-        const Value& operator[](size_t index) const noexcept
+        void Set(Value&& other) noexcept
         {
-            static Value invalid;
-            if (IsArray() && index < VectorSize(AsArray()))
+#if EJSON_VALUE_COMPACT
+            if (other.IsBoxed())
             {
-                return AsArray()[index];
+                // take the box, other may be inside this value
+                void* box = *(void**)other.buffer;
+                const Type otherType = other.type;
+                const NumberType otherNumberType = other.numberType;
+                other.type = Type::Invalid;
+                SetInvalid();
+                type = otherType;
+                numberType = otherNumberType;
+                stringSize = HeapString;
+                *(void**)buffer = box;
+                return;
             }
-            else
+#endif
+            switch (other.type)
             {
-                return invalid;
+                case Type::Invalid:
+                    SetInvalid();
+                    break;
+                case Type::Null:
+                    SetNull();
+                    break;
+                case Type::Bool:
+                    SetBool(other.AsBool());
+                    break;
+                case Type::Number:
+                    if (other.numberType == NumberType::Text && other.stringSize == HeapString)
+                    {
+                        SetInvalid();
+                        type = Type::Number;
+                        numberType = NumberType::Text;
+                        Construct<c_string>(EJSON_MOVE(other.Get<c_string>()));
+                        stringSize = HeapString;
+                    }
+                    else
+                    {
+                        CopyNumber(other);
+                    }
+                    break;
+                case Type::String:
+                    if (other.stringSize == HeapString)
+                    {
+                        SetInvalid();
+                        type = Type::String;
+                        Construct<string>(EJSON_MOVE(other.Get<string>()));
+                        stringSize = HeapString;
+                    }
+                    else
+                    {
+                        SetString(other.AsStringView());
+                    }
+                    break;
+                case Type::Array:
+                    SetArray(EJSON_FORWARD<vector<Value>>(other.AsArray()));
+                    break;
+                case Type::Object:
+                    SetObject(EJSON_FORWARD<map<string, Value>>(other.AsObject()));
+                    break;
             }
+            other.type = Type::Invalid;
         }
 
-        Value& operator[](const string& str) noexcept
+        // Invalid
+
+        bool IsInvalid() const noexcept
         {
-            static Value invalid;
-            if (!IsObject())
-            {
-                SetObject({});
-            }
-            return *MapTryEmplace(AsObject(), str, {});
+            return type == Type::Invalid;
         }
 
-        const Value& operator[](string_view str) const noexcept
+        bool IsValid() const noexcept
         {
-            static Value invalid;
-            if (IsObject())
-            {
-                const Value* value = MapFind(AsObject(), string(str));
-                if (value)
-                    return *value;
-                else
-                    return invalid;
-            }
-            else
+            return !IsInvalid();
+        }
+
+        void SetInvalid() noexcept
+        {
+            switch (type)
             {
-                return invalid;
+                case Type::Invalid:
+                    break;
+                case Type::Null:
+                    break;
+                case Type::Bool:
+                    break;
+                case Type::Number:
+                    if (numberType == NumberType::Text && stringSize == HeapString)
+                        Destroy<c_string>();
+                    break;
+                case Type::String:
+                    if (stringSize == HeapString)
+                        Destroy<string>();
+                    break;
+                case Type::Array:
+                    Destroy<vector<Value>>();
+                    break;
+                case Type::Object:
+                    Destroy<map<string, Value>>();
+                    break;
             }
+            type = Type::Invalid;
         }
 
+        // Null
 
-    private:
+        Value(std::nullptr_t v) noexcept
+        {
+            SetNull();
+        }
 
-        static constexpr size_t ValueSize = std::max(std::max(std::max(sizeof(vector<Value>), sizeof(map<string, void*>)), sizeof(string)), sizeof(number));
-        static constexpr size_t ValueAlign = std::max(std::max(std::max(alignof(vector<Value>), alignof(map<string, void*>)), alignof(string)), alignof(number));
+        Value& operator=(std::nullptr_t v) noexcept
+        {
+            SetNull();
+            return *this;
+        }
 
-        alignas(ValueAlign) char buffer[ValueSize];
-        Type type = Type::Invalid;
+        bool IsNull() const noexcept
+        {
+            return type == Type::Null;
+        }
 
-    };
+        void SetNull() noexcept
+        {
+            SetInvalid();
+            type = Type::Null;
+        }
 
-    template<typename LISTENER, typename STRING_READER>
-    class JsonReader
-    {
-    public:
+        // Bool
 
-        JsonReader(LISTENER& listener, STRING_READER& reader) noexcept
-            :listener(&listener), reader(&reader)
-        {}
+        Value(bool v) noexcept
+        {
+            SetBool(v);
+        }
 
-        bool Parse() noexcept
+        Value& operator=(const bool& v) noexcept
         {
-            if (!reader->Read(next))
-                next = 0;
+            SetBool(v);
+            return *this;
+        }
 
-            if (!ParseNextToken())
-                return false;
+        bool IsBool() const noexcept
+        {
+            return type == Type::Bool;
+        }
 
-            if (!ParseValue())
-                return false;
+        void SetBool(bool value) noexcept
+        {
+            SetInvalid();
+            type = Type::Bool;
+            AsBool() = value;
+        }
 
-            Read();
-            SkipSpaces();
+        bool& AsBool() noexcept
+        {
+            EJSON_ASSERT(type == Type::Bool, "expected type: bool");
+            return *(bool*)buffer;
+        }
 
-            if (HaveError())
-                return false;
+        const bool& AsBool() const noexcept
+        {
+            return const_cast<Value*>(this)->AsBool();
+        }
 
-            if (cur != 0)
-                return ReportError(EJSON_TEXT("invalid input after value"), line, column);
+        // Number
+        //
+        // a number is stored as a floating point number or, for integers, as s64 or u64 (GetNumberType). Integers
+        // are written exactly, GetNumber, AsInt64 and AsUInt64 convert from any of them. SetNumberText keeps the
+        // number as written instead: it is converted on each access and written back unchanged.
+
+        Value(s8 v) noexcept { SetInt64(v); }
+        Value& operator=(s8 v) noexcept { SetInt64(v); return *this; }
+        Value(s16 v) noexcept { SetInt64(v); }
+        Value& operator=(s16 v) noexcept { SetInt64(v); return *this; }
+        Value(s32 v) noexcept { SetInt64(v); }
+        Value& operator=(s32 v) noexcept { SetInt64(v); return *this; }
+        Value(s64 v) noexcept { SetInt64(v); }
+        Value& operator=(s64 v) noexcept { SetInt64(v); return *this; }
+
+        Value(u8 v) noexcept { SetUInt64(v); }
+        Value& operator=(u8 v) noexcept { SetUInt64(v); return *this; }
+        Value(u16 v) noexcept { SetUInt64(v); }
+        Value& operator=(u16 v) noexcept { SetUInt64(v); return *this; }
+        Value(u32 v) noexcept { SetUInt64(v); }
+        Value& operator=(u32 v) noexcept { SetUInt64(v); return *this; }
+        Value(u64 v) noexcept { SetUInt64(v); }
+        Value& operator=(u64 v) noexcept { SetUInt64(v); return *this; }
 
-            return true;
-        }
+        Value(f32 v) noexcept { SetNumber(v); }
+        Value& operator=(f32 v) noexcept { SetNumber(v); return *this; }
+        Value(f64 v) noexcept { SetNumber((number)v); }
+        Value& operator=(f64 v) noexcept { SetNumber((number)v); return *this; }
 
-        ParserError GetError() const noexcept { return error; }
-        bool HaveError() const noexcept { return StringSize(error.Error) != 0; }
+        bool IsNumber() const noexcept
+        {
+            return type == Type::Number;
+        }
 
-    private:
+        NumberType GetNumberType() const noexcept
+        {
+            EJSON_ASSERT(type == Type::Number, "expected type: number");
+            return numberType;
+        }
 
-        enum class Token : std::uint8_t
+        void SetNumber(number value) noexcept
         {
-            Invalid,
-            CurlyOpen,
-            CurlyClose,
-            SquaredOpen,
-            SquaredClose,
-            Colon,
-            Comma,
-            String,
-            Number,
-            True,
-            False,
-            Null
-        };
+            SetInvalid();
+            type = Type::Number;
+            numberType = NumberType::Float;
+            static_assert(sizeof(number) <= ValueSize);
+            static_assert(alignof(number) <= ValueAlign);
+            *(number*)buffer = value;
+        }
 
-        LISTENER* listener = nullptr;
-        STRING_READER* reader = nullptr;
-        string_char cur = 0;
-        string_char next = 0;
-        Token token = Token::Invalid;
-        string value;
-        ParserError error;
-        u32 line = 1;
-        u32 column = 0;
-        u32 tokenLine = 1;
-        u32 tokenColumn = 0;
+        void SetInt64(s64 value) noexcept
+        {
+            SetInvalid();
+            type = Type::Number;
+            numberType = NumberType::Int64;
+            static_assert(sizeof(s64) <= ValueSize);
+            static_assert(alignof(s64) <= ValueAlign);
+            *(s64*)buffer = value;
+        }
 
-        bool Read() noexcept
+        void SetUInt64(u64 value) noexcept
         {
-            cur = next;
+            SetInvalid();
+            type = Type::Number;
+            numberType = NumberType::UInt64;
+            *(u64*)buffer = value;
+        }
 
-            if (cur == L'\n')
-            {
-                ++line;
-                column = 0;
-            }
-            else
+        void SetNumber(const NumberToken& token) noexcept
+        {
+            switch (token.Type)
             {
-                ++column;
+                case NumberType::Int64:
+                    SetInt64(token.Int64);
+                    break;
+                case NumberType::UInt64:
+                    SetUInt64(token.UInt64);
+                    break;
+                default:
+                    SetNumber(token.Value);
+                    break;
             }
+        }
 
-            if (cur == 0)
-                return false;
-            if (!reader->Read(next))
-                next = 0;
-
-            if (cur == L'\r')
+        // text is a number as accepted by the parser, kept in the value storage or in a c_string when longer
+        void SetNumberText(string_view text) noexcept
+        {
+            if (StringSize(text) > NumberTextCapacity)
             {
-                if (next != L'\n')
-                    return ReportError(EJSON_TEXT("invalid line ending"));
-                ++line;
-                column = 0;
-                cur = next;
-                if (!reader->Read(next))
-                    next = 0;
+                SetInvalid();
+                type = Type::Number;
+                numberType = NumberType::Text;
+                Construct<c_string>(text.begin(), text.end());
+                stringSize = HeapString;
+                return;
             }
+            SetInvalid();
+            type = Type::Number;
+            numberType = NumberType::Text;
+            for (size_t i = 0; i < StringSize(text); ++i)
+                buffer[i] = (char)text[i];
+            buffer[NumberTextCapacity] = (char)StringSize(text);
+            stringSize = 0;
+        }
 
-            return true;
+        // the text of a NumberType::Text number
+        c_string_view GetNumberText() const noexcept
+        {
+            EJSON_ASSERT(type == Type::Number && numberType == NumberType::Text, "expected type: number text");
+            if (stringSize == HeapString)
+                return c_string_view(Get<c_string>());
+            return c_string_view(buffer, (size_t)(unsigned char)buffer[NumberTextCapacity]);
         }
 
-        bool SkipSpaces() noexcept
+        // an integer or a text number becomes a floating point number, the reference may be written
+        number& AsNumber() noexcept
         {
-            while (cur == L' ' || cur == L'\t' || cur == L'\n')
-            {
-                if (!Read())
-                    return false;
-            }
-            return true;
+            EJSON_ASSERT(type == Type::Number, "expected type: number");
+            if (numberType != NumberType::Float)
+                SetNumber(GetNumber());
+            return *(number*)buffer;
         }
 
-        bool ReportError(const string_view& msg, int l = -1, int c= -1) noexcept
+        number AsNumber() const noexcept
         {
-            error.Line = l == -1 ? tokenLine : l;
-            error.Column = c == -1 ? tokenColumn : c;
-            error.Error = msg;
-            return false;
+            return GetNumber();
         }
 
-        bool ParseLiteral(const string_char* literal) noexcept
+        // the number as a floating point number, the number type is kept (also on a non const value)
+        number GetNumber() const noexcept
         {
-            EJSON_ASSERT(literal[0] == cur, "internal error");
-            size_t i = 1;
-            while (literal[i] == next && next != 0)
+            EJSON_ASSERT(type == Type::Number, "expected type: number");
+            switch (numberType)
             {
-                ++i;
-                if (!Read())
-                    return ReportError(EJSON_TEXT("expected: literal"));
+                case NumberType::Int64:
+                    return (number)*(const s64*)buffer;
+                case NumberType::UInt64:
+                    return (number)*(const u64*)buffer;
+                case NumberType::Text:
+                    return ParseNumberText().Value;
+                default:
+                    return *(const number*)buffer;
             }
-            if (literal[i] == 0)
-                return true;
-            else
-                return ReportError(EJSON_TEXT("expected: literal"));
         }
 
-        bool ParseNumber() noexcept
+        // floating point numbers are truncated toward zero and saturated to the s64 range, NaN gives 0
+        s64 AsInt64() const noexcept
         {
-            StringClear(value);
-
-            if (cur == L'-')
+            EJSON_ASSERT(type == Type::Number, "expected type: number");
+            switch (numberType)
             {
-                if (!Read())
-                    return ReportError(EJSON_TEXT("invalid number"));
-                StringAdd(value, EJSON_TEXT('-'));
+                case NumberType::Int64:
+                    return *(const s64*)buffer;
+                case NumberType::UInt64:
+                    return (s64)*(const u64*)buffer;
+                case NumberType::Text:
+                {
+                    Value converted;
+                    converted.SetNumber(ParseNumberText());
+                    return converted.AsInt64();
+                }
+                default:
+                    return FloatToInt<s64>(*(const number*)buffer);
             }
+        }
 
-            bool valid = false;
-            while ((cur >= L'0' && cur <= L'9') || cur == L'.')
+        // floating point numbers are truncated toward zero and saturated to the u64 range, NaN gives 0
+        u64 AsUInt64() const noexcept
+        {
+            EJSON_ASSERT(type == Type::Number, "expected type: number");
+            switch (numberType)
             {
-                // cannot start with '.'
-                if (!valid && cur == L'.')
-                    return ReportError(EJSON_TEXT("invalid number"));
-
-                StringAdd(value, cur);
-                valid = true;
-                if ((next < EJSON_TEXT('0') || next > EJSON_TEXT('9')) && next != L'.')
-                    break;
-                Read();
+                case NumberType::Int64:
+                    return (u64)*(const s64*)buffer;
+                case NumberType::UInt64:
+                    return *(const u64*)buffer;
+                case NumberType::Text:
+                {
+                    Value converted;
+                    converted.SetNumber(ParseNumberText());
+                    return converted.AsUInt64();
+                }
+                default:
+                    return FloatToInt<u64>(*(const number*)buffer);
             }
-            // cannot end with '.'
-            if (cur == L'.')
-                return ReportError(EJSON_TEXT("invalid number"));
-
-            return valid;
         }
 
-        bool ParseString() noexcept
+        // String
+        //
+        // strings up to InlineStringCapacity characters are stored in the value itself, longer ones in a string.
+        // AsStringView reads both, AsString moves a short string to a string first (a const value gives a copy).
+
+        Value(const string& str) noexcept
         {
-            EJSON_ASSERT(cur == EJSON_TEXT('"'), "internal error");
+            SetString(string_view(str));
+        }
 
-            StringClear(value);
+        Value(string&& str) noexcept
+        {
+            SetString(EJSON_FORWARD<string>(str));
+        }
 
-            while (true)
-            {
-                if (!Read())
-                    return ReportError(EJSON_TEXT("invalid string"));
+        Value(const string_char* str) noexcept
+        {
+            SetString(string_view(str));
+        }
 
-                if (cur == L'"')
-                    return true;
+        Value& operator=(const string& str) noexcept
+        {
+            SetString(string_view(str));
+            return *this;
+        }
 
-                StringAdd(value, cur);
+        Value& operator=(string&& str) noexcept
+        {
+            SetString(EJSON_FORWARD<string>(str));
+            return *this;
+        }
 
-                // skip '\'
-                if (cur == L'\\')
-                {
-                    if (next != L'\"' &&
-                        next != L'\\' &&
-                        next != L'/' &&
-                        next != L'b' &&
-                        next != L'f' &&
-                        next != L'n' &&
-                        next != L'r' &&
-                        next != L't' &&
-                        next != L'u')
-                        return ReportError(EJSON_TEXT("invalid escape car"));
+        Value& operator=(const string_char* str) noexcept
+        {
+            SetString(string_view(str));
+            return *this;
+        }
 
-                    if (next == L'u')
-                    {
-                        // must be followed by 4 numbers
-                        for (int i = 0; i < 4; ++i)
-                        {
-                            Read();
-                            StringAdd(value, cur);
-                            if (next < L'0' || next > '9')
-                                return ReportError(EJSON_TEXT("escape \\u in string must be followed by 4 numbers"));
-                        }
-                    }
+        bool IsString() const noexcept
+        {
+            return type == Type::String;
+        }
 
-                    Read();
-                    StringAdd(value, cur);
-                }
+        void SetString(string_view value) noexcept
+        {
+            if (StringSize(value) > InlineStringCapacity)
+            {
+                SetString(string(value));
+                return;
             }
+            // value may point in this value, its string is released by SetInvalid
+            string_char chars[InlineStringCapacity];
+            const size_t size = StringSize(value);
+            std::memcpy(chars, value.data(), size * sizeof(string_char));
+            SetInvalid();
+            type = Type::String;
+            std::memcpy(buffer, chars, size * sizeof(string_char));
+            stringSize = (u8)size;
         }
 
-        bool ParseNextToken() noexcept
+        void SetString(const string& value) noexcept
+        {
+            SetString(string_view(value));
+        }
+
+        void SetString(const string_char* value) noexcept
+        {
+            SetString(string_view(value));
+        }
+
+        void SetString(string&& value) noexcept
+        {
+            if (StringSize(value) <= InlineStringCapacity)
+            {
+                SetString(string_view(value));
+                return;
+            }
+            // value may be the string of this value
+            string moved(EJSON_FORWARD<string>(value));
+            SetInvalid();
+            type = Type::String;
+            Construct<string>(EJSON_MOVE(moved));
+            stringSize = HeapString;
+        }
+
+        string_view AsStringView() const noexcept
+        {
+            EJSON_ASSERT(type == Type::String, "expected type: string");
+            if (stringSize == HeapString)
+                return string_view(Get<string>());
+            return string_view((const string_char*)buffer, stringSize);
+        }
+
+        string& AsString() noexcept
+        {
+            EJSON_ASSERT(type == Type::String, "expected type: string");
+            if (stringSize != HeapString)
+            {
+                string value(AsStringView());
+                Construct<string>(EJSON_MOVE(value));
+                stringSize = HeapString;
+            }
+            return Get<string>();
+        }
+
+        string AsString() const noexcept
+        {
+            return string(AsStringView());
+        }
+
+        // Array
+
+        Value(const vector<Value>& value) noexcept
+        {
+            SetArray(value);
+        }
+
+        Value& operator=(const vector<Value>& value) noexcept
+        {
+            SetArray(value);
+            return *this;
+        }
+
+        bool IsArray() const noexcept
+        {
+            return type == Type::Array;
+        }
+
+        void SetArray(const vector<Value>& value) noexcept
+        {
+            SetInvalid();
+            type = Type::Array;
+            Construct<vector<Value>>(value);
+        }
+
+        void SetArray(vector<Value>&& value) noexcept
+        {
+            SetInvalid();
+            type = Type::Array;
+            Construct<vector<Value>>(EJSON_FORWARD<vector<Value>>(value));
+        }
+
+        vector<Value>& AsArray() noexcept
+        {
+            EJSON_ASSERT(type == Type::Array, "expected type: array");
+            return Get<vector<Value>>();
+        }
+
+        const vector<Value>& AsArray() const noexcept
+        {
+            return const_cast<Value*>(this)->AsArray();
+        }
+
+        Value& operator[](size_t index) noexcept
+        {
+            static Value invalid;
+            if (!IsArray())
+                SetArray({});
+            vector<Value>& array = AsArray();
+            while(VectorSize(array) <= index )
+                VectorEmplace(array, {});
+
+            return AsArray()[index];
+        }
+
+        // Object
+
+        Value(const map<string, Value>& value) noexcept
+        {
+            SetObject(value);
+        }
+
+        Value& operator=(const map<string, Value>& value) noexcept
+        {
+            SetObject(value);
+            return *this;
+        }
+
+        bool IsObject() const noexcept
+        {
+            return type == Type::Object;
+        }
+
+        void SetObject(const map<string, Value>& value) noexcept
+        {
+            SetInvalid();
+            type = Type::Object;
+            Construct<map<string, Value>>(value);
+        }
+
+        void SetObject(map<string, Value>&& value) noexcept
+        {
+            SetInvalid();
+            type = Type::Object;
+            Construct<map<string, Value>>(EJSON_FORWARD<map<string, Value>>(value));
+        }
+
+        map<string, Value>& AsObject() noexcept
+        {
+            EJSON_ASSERT(type == Type::Object, "expected type: object");
+            return Get<map<string, Value>>();
+        }
+
+        const map<string, Value>& AsObject() const noexcept
+        {
+            return const_cast<Value*>(this)->AsObject();
+        }
+
+        const Value& operator[](size_t index) const noexcept
+        {
+            static Value invalid;
+            if (IsArray() && index < VectorSize(AsArray()))
+            {
+                return AsArray()[index];
+            }
+            else
+            {
+                return invalid;
+            }
+        }
+
+        Value& operator[](const string& str) noexcept
+        {
+            static Value invalid;
+            if (!IsObject())
+            {
+                SetObject({});
+            }
+            return *MapTryEmplace(AsObject(), str, {});
+        }
+
+        const Value& operator[](string_view str) const noexcept
+        {
+            static Value invalid;
+            if (IsObject())
+            {
+                const Value* value = MapFind(AsObject(), string(str));
+                if (value)
+                    return *value;
+                else
+                    return invalid;
+            }
+            else
+            {
+                return invalid;
+            }
+        }
+
+
+    private:
+
+#if EJSON_VALUE_COMPACT
+        // a pointer or a number, with the tags after it the value is 16 bytes
+        static constexpr size_t ValueSize = 16 - 3;
+        static constexpr size_t ValueAlign = 8;
+#else
+        static constexpr size_t ValueSize = std::max(std::max(std::max(sizeof(vector<Value>), sizeof(map<string, void*>)), sizeof(string)), sizeof(number));
+        static constexpr size_t ValueAlign = std::max(std::max(std::max(alignof(vector<Value>), alignof(map<string, void*>)), alignof(string)), alignof(number));
+#endif
+        // ascii characters of a NumberType::Text number, its length in the last byte
+        static constexpr size_t NumberTextCapacity = ValueSize - 1;
+        static constexpr size_t InlineStringCapacity = std::min(ValueSize / sizeof(string_char), (size_t)254);
+        // stringSize of a string stored in a string
+        static constexpr u8 HeapString = 255;
+
+        // truncated toward zero, saturated to the range of T (2^63 and 2^64 are exact as number), NaN gives 0
+        template<typename T>
+        static T FloatToInt(number value) noexcept
+        {
+            if (value != value)
+                return 0;
+            if (value >= (number)std::numeric_limits<T>::max())
+                return std::numeric_limits<T>::max();
+            if (value <= (number)std::numeric_limits<T>::min())
+                return std::numeric_limits<T>::min();
+            return (T)value;
+        }
+
+        void CopyNumber(const Value& other) noexcept
+        {
+            switch (other.numberType)
+            {
+                case NumberType::Int64:
+                    SetInt64(other.AsInt64());
+                    break;
+                case NumberType::UInt64:
+                    SetUInt64(other.AsUInt64());
+                    break;
+                case NumberType::Text:
+                    SetInvalid();
+                    type = Type::Number;
+                    numberType = NumberType::Text;
+                    if (other.stringSize == HeapString)
+                    {
+                        Construct<c_string>(other.Get<c_string>());
+                        stringSize = HeapString;
+                        break;
+                    }
+                    std::memcpy(buffer, other.buffer, ValueSize);
+                    stringSize = 0;
+                    break;
+                default:
+                    SetNumber(other.GetNumber());
+                    break;
+            }
+        }
+
+        // arrays, objects and heap strings are in the buffer, or behind a pointer in it with EJSON_VALUE_COMPACT
+        template<typename T, typename... ARGS>
+        void Construct(ARGS&&... args) noexcept
+        {
+#if EJSON_VALUE_COMPACT
+    #if EJSON_ARENA
+            // the box comes from the resource of its content, found again when it is freed
+            T content(EJSON_FORWARD<ARGS>(args)...);
+            Allocator<T> allocator(content.get_allocator().resource());
+            T* box = allocator.allocate(1);
+            new (box) T(EJSON_MOVE(content));
+    #else
+            T* box = new T(EJSON_FORWARD<ARGS>(args)...);
+    #endif
+            *(T**)buffer = box;
+#else
+            static_assert(sizeof(T) <= ValueSize);
+            static_assert(alignof(T) <= ValueAlign);
+            new (buffer) T(EJSON_FORWARD<ARGS>(args)...);
+#endif
+        }
+
+        template<typename T>
+        T& Get() noexcept
+        {
+#if EJSON_VALUE_COMPACT
+            return **(T**)buffer;
+#else
+            return *(T*)buffer;
+#endif
+        }
+
+        template<typename T>
+        const T& Get() const noexcept
+        {
+            return const_cast<Value*>(this)->Get<T>();
+        }
+
+#if EJSON_VALUE_COMPACT
+        // the payload is a pointer: arrays, objects, long strings and long number texts
+        bool IsBoxed() const noexcept
+        {
+            switch (type)
+            {
+                case Type::Array:
+                case Type::Object:
+                    return true;
+                case Type::String:
+                    return stringSize == HeapString;
+                case Type::Number:
+                    return numberType == NumberType::Text && stringSize == HeapString;
+                default:
+                    return false;
+            }
+        }
+#endif
+
+        template<typename T>
+        void Destroy() noexcept
+        {
+#if EJSON_VALUE_COMPACT
+    #if EJSON_ARENA
+            T* box = *(T**)buffer;
+            Allocator<T> allocator(box->get_allocator().resource());
+            box->~T();
+            allocator.deallocate(box, 1);
+    #else
+            delete *(T**)buffer;
+    #endif
+#else
+            ((T*)buffer)->~T();
+#endif
+        }
+
+        NumberToken ParseNumberText() const noexcept
+        {
+            const c_string_view chars = GetNumberText();
+            string_char shortText[NumberTextCapacity];
+            string longText;
+            string_char* text = shortText;
+            if (StringSize(chars) > NumberTextCapacity)
+            {
+                longText.resize(StringSize(chars));
+                text = longText.data();
+            }
+            for (size_t i = 0; i < StringSize(chars); ++i)
+                text[i] = (string_char)chars[i];
+            NumberToken token;
+            ParseNumber(string_view(text, StringSize(chars)), token);
+            token.Text = string_view();
+            return token;
+        }
+
+        alignas(ValueAlign) char buffer[ValueSize];
+        Type type = Type::Invalid;
+        NumberType numberType = NumberType::Float;
+        // length of an inline string, or HeapString
+        u8 stringSize = HeapString;
+
+    };
+
+#if EJSON_VALUE_COMPACT
+    static_assert(sizeof(Value) == 16);
+#endif
+
+    // Listeners
+    //
+    // A listener receives the parse as callbacks:
+    //
+    //     ObjectBegin(), ObjectEnd(), PropertyBegin(const string_view& name), PropertyEnd(), ArrayBegin(),
+    //     ArrayEnd(), ValueBool(bool), ValueNull(), ValueString(const string_view&), ValueNumber(const string_view&)
+    //
+    // ObjectBegin, ArrayBegin and PropertyBegin may return Listen::Skip instead of void: the rest of the
+    // object or array, or the property value, is jumped over without callbacks, and the callback that asked
+    // for the skip gets no matching end (ObjectEnd, ArrayEnd, PropertyEnd). Skipped containers are only
+    // checked for closed strings and balanced brackets.
+    //
+    // A listener may take ValueNumber(const NumberToken&) instead of ValueNumber(const string_view&): the number
+    // is then converted by the tokenizer while it scans it, and the text is still given in the token.
+
+    enum class Listen : std::uint8_t
+    {
+        Continue,
+        Skip
+    };
+
+    template<typename LISTENER>
+    constexpr bool ListensNumberTokens = requires(LISTENER& listener, const NumberToken& token) { listener.ValueNumber(token); };
+
+    // call a listener callback returning void or Listen, true if it asks to skip
+    template<typename CALLBACK>
+    bool ListenerSkips(CALLBACK&& callback) noexcept
+    {
+        if constexpr (std::is_void_v<decltype(callback())>)
+        {
+            callback();
+            return false;
+        }
+        else
+        {
+            return callback() == Listen::Skip;
+        }
+    }
+
+    // Input readers
+    //
+    // A buffer reader hands out the input as contiguous spans:
+    //
+    //     bool Fill(const string_char*& begin, const string_char*& end) noexcept;
+    //
+    // Fill returns the next non empty span, or false at the end of input (begin/end are left untouched).
+    // A span stays valid until the next call to Fill, readers that keep every span valid for their whole
+    // lifetime declare it with:
+    //
+    //     static constexpr bool StableSpans = true;
+    //
+    // A char reader hands out the input one character at a time:
+    //
+    //     bool Read(string_char& car) noexcept;
+    //
+    // JsonReader works on spans, char readers are wrapped in a CharReader.
+
+    template<typename READER>
+    constexpr bool IsBufferReader = requires(READER& reader, const string_char*& begin, const string_char*& end)
+    {
+        reader.Fill(begin, end);
+    };
+
+    template<typename READER>
+    constexpr bool HasStableSpans = requires { requires READER::StableSpans; };
+
+    template<typename CHAR_READER>
+    class CharReader
+    {
+    public:
+
+        CharReader(CHAR_READER& reader) noexcept
+            : reader(reader)
+        {}
+
+        CharReader(const CharReader&) = delete;
+        CharReader& operator=(const CharReader&) = delete;
+        ~CharReader() noexcept {}
+
+        bool Fill(const string_char*& begin, const string_char*& end) noexcept
+        {
+            size_t size = 0;
+            while (size < BufferSize && reader.Read(buffer[size]))
+                ++size;
+
+            if (size == 0)
+                return false;
+
+            begin = buffer;
+            end = buffer + size;
+            return true;
+        }
+
+    private:
+
+        static constexpr size_t BufferSize = 256;
+
+        CHAR_READER& reader;
+        string_char buffer[BufferSize];
+    };
+
+    // JsonReader parses json from STRING_READER and reports it to LISTENER callbacks:
+    //
+    //     ObjectBegin(), ObjectEnd(), PropertyBegin(const string_view& name), PropertyEnd(),
+    //     ArrayBegin(), ArrayEnd(), ValueBool(bool), ValueNull(),
+    //     ValueString(const string_view& str), ValueNumber(const string_view& str)
+    //
+    // string_view arguments are only valid during the call: strings without escape point straight into
+    // the reader span, nothing is copied by the tokenizer.
+    template<typename LISTENER, typename STRING_READER>
+    class JsonReader
+    {
+    public:
+
+        JsonReader(LISTENER& listener, STRING_READER& reader) noexcept
+            :listener(&listener), reader(reader)
+        {}
+
+        bool Parse() noexcept
+        {
+            if (!ParseNextToken())
+                return false;
+
+            if (!ParseValue())
+                return false;
+
+            Read();
+            SkipSpaces();
+
+            if (HaveError())
+                return false;
+
+            if (cur != 0)
+            {
+                u32 line = 0;
+                u32 column = 0;
+                Locate(pos - 1, line, column);
+                return ReportError(EJSON_TEXT("invalid input after value"), line, column);
+            }
+
+            return true;
+        }
+
+        ParserError GetError() const noexcept { return error; }
+        bool HaveError() const noexcept { return StringSize(error.Error) != 0; }
+
+    private:
+
+        // JsonCursor drives the tokenizer itself
+        template<typename> friend class JsonCursor;
+
+        enum class Token : std::uint8_t
+        {
+            Invalid,
+            CurlyOpen,
+            CurlyClose,
+            SquaredOpen,
+            SquaredClose,
+            Colon,
+            Comma,
+            String,
+            Number,
+            True,
+            False,
+            Null
+        };
+
+        using Reader = std::conditional_t<IsBufferReader<STRING_READER>, STRING_READER&, CharReader<STRING_READER>>;
+
+        LISTENER* listener = nullptr;
+        Reader reader;
+        // current span, pos is the character following cur
+        const string_char* pos = nullptr;
+        const string_char* end = nullptr;
+        string_char cur = 0;
+        Token token = Token::Invalid;
+        // text of the current string/number token, either a view on the input span or on value
+        string_view text;
+        string value;
+        // converted number token, for listeners taking NumberToken
+        NumberToken numberToken;
+        ParserError error;
+        // only positions are tracked while parsing, lines are counted when a span is dropped or on error:
+        // spanLine/spanLineChars is the position of spanBegin, tokenStart the current token if it is in the span
+        const string_char* spanBegin = nullptr;
+        const string_char* tokenStart = nullptr;
+        u32 spanLine = 1;
+        u32 spanLineChars = 0;
+        u32 tokenLine = 1;
+        u32 tokenColumn = 0;
+
+        string_char Peek() noexcept
+        {
+            if (pos == end && !NextSpan())
+                return 0;
+            return *pos;
+        }
+
+        bool NextSpan() noexcept
+        {
+            if constexpr (HasStableSpans<STRING_READER>)
+            {
+                // the span stays valid, nothing is counted when the input ends
+                const string_char* spanEnd = end;
+                if (!reader.Fill(pos, end))
+                    return false;
+                DropSpan(spanEnd);
+            }
+            else
+            {
+                // the span is about to be overwritten
+                DropSpan(end);
+                if (!reader.Fill(pos, end))
+                    return false;
+            }
+            spanBegin = pos;
+            return true;
+        }
+
+        // count the lines of the span and resolve the token position if it is still in it
+        void DropSpan(const string_char* spanEnd) noexcept
+        {
+            if (tokenStart != nullptr)
+            {
+                Locate(tokenStart, tokenLine, tokenColumn);
+                tokenStart = nullptr;
+            }
+            CountLines(spanBegin, spanEnd, spanLine, spanLineChars);
+            spanBegin = spanEnd;
+        }
+
+        // line and column of p in the current span
+        void Locate(const string_char* p, u32& line, u32& column) const noexcept
+        {
+            u32 lineChars = spanLineChars;
+            line = spanLine;
+            CountLines(spanBegin, p, line, lineChars);
+            column = lineChars + 1;
+        }
+
+        bool Read() noexcept
+        {
+            cur = Peek();
+
+            if (cur == 0)
+                return false;
+            ++pos;
+
+            if (cur == L'\r')
+            {
+                if (Peek() != L'\n')
+                    return ReportError(EJSON_TEXT("invalid line ending"));
+                cur = *pos;
+                ++pos;
+            }
+
+            return true;
+        }
+
+        bool SkipSpaces() noexcept
+        {
+            while (cur == L' ' || cur == L'\t' || cur == L'\n')
+            {
+                // skip the rest of the run in bulk
+                pos = SkipWhitespaces(pos, end);
+
+                if (!Read())
+                    return false;
+            }
+            return true;
+        }
+
+        bool ReportError(const string_view& msg, int l = -1, int c= -1) noexcept
+        {
+            if (l == -1 && tokenStart != nullptr)
+            {
+                Locate(tokenStart, tokenLine, tokenColumn);
+                tokenStart = nullptr;
+            }
+            error.Line = l == -1 ? tokenLine : l;
+            error.Column = c == -1 ? tokenColumn : c;
+            error.Error = msg;
+            return false;
+        }
+
+        bool ParseLiteral(const string_char* literal) noexcept
+        {
+            EJSON_ASSERT(literal[0] == cur, "internal error");
+            size_t i = 1;
+            while (literal[i] == Peek() && Peek() != 0)
+            {
+                ++i;
+                if (!Read())
+                    return ReportError(EJSON_TEXT("expected: literal"));
+            }
+            if (literal[i] == 0)
+                return true;
+            else
+                return ReportError(EJSON_TEXT("expected: literal"));
+        }
+
+        bool ParseNumber() noexcept
+        {
+            if constexpr (ListensNumberTokens<LISTENER>)
+            {
+                // the whole number in the span: converted in the same pass, the text is a view on the span
+                const string_char* begin = pos - 1;
+                const string_char* numberEnd = ParseNumberPrefix<false>(begin, end, numberToken);
+                if (numberEnd != nullptr && numberEnd != end && numberEnd[-1] != EJSON_TEXT('.') && *numberEnd != EJSON_TEXT('.'))
+                {
+                    text = string_view(begin, numberEnd - begin);
+                    numberToken.Text = text;
+                    pos = numberEnd;
+                    cur = numberEnd[-1];
+                    return true;
+                }
+            }
+            else
+            {
+                // the whole number in the span: the text is a view on the span
+                const string_char* begin = pos - 1;
+                const string_char* numberEnd = *begin == EJSON_TEXT('-') ? pos : begin;
+                if (numberEnd != end && IsDigit(*numberEnd))
+                {
+                    while (numberEnd != end && (IsDigit(*numberEnd) || *numberEnd == EJSON_TEXT('.')))
+                        ++numberEnd;
+                    if (numberEnd != end && numberEnd[-1] != EJSON_TEXT('.'))
+                    {
+                        text = string_view(begin, numberEnd - begin);
+                        pos = numberEnd;
+                        cur = numberEnd[-1];
+                        return true;
+                    }
+                }
+            }
+
+            StringClear(value);
+
+            if (cur == L'-')
+            {
+                if (!Read())
+                    return ReportError(EJSON_TEXT("invalid number"));
+                StringAdd(value, EJSON_TEXT('-'));
+            }
+
+            bool valid = false;
+            while ((cur >= L'0' && cur <= L'9') || cur == L'.')
+            {
+                // cannot start with '.'
+                if (!valid && cur == L'.')
+                    return ReportError(EJSON_TEXT("invalid number"));
+
+                StringAdd(value, cur);
+                valid = true;
+                string_char next = Peek();
+                if ((next < EJSON_TEXT('0') || next > EJSON_TEXT('9')) && next != L'.')
+                    break;
+                Read();
+            }
+            // cannot end with '.'
+            if (cur == L'.')
+                return ReportError(EJSON_TEXT("invalid number"));
+
+            text = value;
+            if constexpr (ListensNumberTokens<LISTENER>)
+                ::ejson::ParseNumber(text, numberToken);
+            return valid;
+        }
+
+        bool ParseString() noexcept
+        {
+            EJSON_ASSERT(cur == EJSON_TEXT('"'), "internal error");
+
+            const string_char* runEnd = ScanString(pos, end);
+
+            // closing quote in the current span and nothing to process: the token is a view on the input
+            if (runEnd != end && *runEnd == EJSON_TEXT('"'))
+            {
+                text = string_view(pos, runEnd - pos);
+                pos = runEnd;
+                Read();
+                return true;
+            }
+
+            StringClear(value);
+
+            while (true)
+            {
+                // append the run of plain characters at once, escapes and control characters go through Read()
+                StringAdd(value, pos, runEnd);
+                pos = runEnd;
+
+                if (!Read())
+                    return ReportError(EJSON_TEXT("invalid string"));
+
+                if (cur == L'"')
+                {
+                    text = value;
+                    return true;
+                }
+
+                StringAdd(value, cur);
+
+                // skip '\'
+                if (cur == L'\\')
+                {
+                    string_char next = Peek();
+                    if (next != L'\"' &&
+                        next != L'\\' &&
+                        next != L'/' &&
+                        next != L'b' &&
+                        next != L'f' &&
+                        next != L'n' &&
+                        next != L'r' &&
+                        next != L't' &&
+                        next != L'u')
+                        return ReportError(EJSON_TEXT("invalid escape car"));
+
+                    if (next == L'u')
+                    {
+                        // must be followed by 4 numbers
+                        for (int i = 0; i < 4; ++i)
+                        {
+                            Read();
+                            StringAdd(value, cur);
+                            if (Peek() < L'0' || Peek() > '9')
+                                return ReportError(EJSON_TEXT("escape \\u in string must be followed by 4 numbers"));
+                        }
+                    }
+
+                    Read();
+                    StringAdd(value, cur);
+                }
+
+                runEnd = ScanString(pos, end);
+            }
+        }
+
+        bool ParseNextToken() noexcept
         {
             if (!Read())
                 return ReportError(EJSON_TEXT("invalid token"));
             if (!SkipSpaces())
                 return ReportError(EJSON_TEXT("invalid token"));
 
-            tokenLine = line;
-            tokenColumn = column;
-            token = Token::Invalid;
-            switch (cur)
+            tokenStart = pos - 1;
+            token = Token::Invalid;
+            switch (cur)
+            {
+                case EJSON_TEXT('{'):
+                {
+                    token = Token::CurlyOpen;
+                    return true;
+                }
+                case EJSON_TEXT('}'):
+                {
+                    token = Token::CurlyClose;
+                    return true;
+                }
+                case EJSON_TEXT('['):
+                {
+                    token = Token::SquaredOpen;
+                    return true;
+                }
+                case EJSON_TEXT(']'):
+                {
+                    token = Token::SquaredClose;
+                    return true;
+                }
+                case EJSON_TEXT(','):
+                {
+                    token = Token::Comma;
+                    return true;
+                }
+                case EJSON_TEXT(':'):
+                {
+                    token = Token::Colon;
+                    return true;
+                }
+                case '0':
+                case '1':
+                case '2':
+                case '3':
+                case '4':
+                case '5':
+                case '6':
+                case '7':
+                case '8':
+                case '9':
+                case '-':
+                {
+                    if (!ParseNumber())
+                        return false;
+                    token = Token::Number;
+                    return true;
+                }
+                case EJSON_TEXT('"'):
+                {
+                    if (!ParseString())
+                        return false;
+                    token = Token::String;
+                    return true;
+                }
+                case EJSON_TEXT('t'):
+                {
+                    if (!ParseLiteral(EJSON_TEXT("true")))
+                        return false;
+                    token = Token::True;
+                    return true;
+                }
+                case EJSON_TEXT('f'):
+                {
+                    if (!ParseLiteral(EJSON_TEXT("false")))
+                        return false;
+                    token = Token::False;
+                    return true;
+                }
+                case EJSON_TEXT('n'):
+                {
+                    if (!ParseLiteral(EJSON_TEXT("null")))
+                        return false;
+                    token = Token::Null;
+                    return true;
+                }
+                default:
+                    return ReportError(EJSON_TEXT("invalid token"));
+            }
+        }
+
+        bool ParseValue() noexcept
+        {
+            switch (token)
+            {
+                case Token::CurlyOpen:
+                    return ParseObject();
+                case Token::SquaredOpen:
+                    return ParseArray();
+                case Token::Number:
+                    if constexpr (ListensNumberTokens<LISTENER>)
+                        listener->ValueNumber(numberToken);
+                    else
+                        listener->ValueNumber(text);
+                    return true;
+                case Token::String:
+                    listener->ValueString(text);
+                    return true;
+                case Token::Null:
+                    listener->ValueNull();
+                    return true;
+                case Token::True:
+                    listener->ValueBool(true);
+                    return true;
+                case Token::False:
+                    listener->ValueBool(false);
+                    return true;
+                default:
+                    return ReportError(EJSON_TEXT("unexpected value"));
+            }
+        }
+
+        bool ParseObject() noexcept
+        {
+            EJSON_ASSERT(token == Token::CurlyOpen, "internal error");
+
+            if (ListenerSkips([&] { return listener->ObjectBegin(); }))
+                return SkipContainer();
+
+            while (true)
+            {
+                if (!ParseNextToken())
+                    return false;
+
+                switch (token)
+                {
+                    case Token::String:
+                    {
+                        if (!ParseProperty())
+                            return false;
+
+                        if (!ParseNextToken())
+                            return false;
+                        switch (token)
+                        {
+                            case Token::Comma:
+                                break;
+                            case Token::CurlyClose:
+                                listener->ObjectEnd();
+                                return true;
+                            default:
+                                return ReportError(EJSON_TEXT("unexpected token after object property"));
+                        }
+                        break;
+                    }
+                    default:
+                        return ReportError(EJSON_TEXT("unexpected object property"));
+                }
+            }
+        }
+
+        bool ParseProperty() noexcept
+        {
+            EJSON_ASSERT(token == Token::String, "internal error");
+
+            const bool skip = ListenerSkips([&] { return listener->PropertyBegin(text); });
+
+            if (!ParseNextToken())
+                return false;
+
+            if (token != Token::Colon)
+                return ReportError(EJSON_TEXT("unexpected object property, missing ':'"));
+
+            if (!ParseNextToken())
+                return false;
+
+            if (skip)
+                return SkipValue();
+
+            if (!ParseValue())
+                return false;
+
+            listener->PropertyEnd();
+            return true;
+        }
+
+        // a value without callbacks: containers are skipped raw, scalars are already read
+        bool SkipValue() noexcept
+        {
+            switch (token)
+            {
+                case Token::CurlyOpen:
+                case Token::SquaredOpen:
+                    return SkipContainer();
+                case Token::Number:
+                case Token::String:
+                case Token::Null:
+                case Token::True:
+                case Token::False:
+                    return true;
+                default:
+                    return ReportError(EJSON_TEXT("unexpected value"));
+            }
+        }
+
+        // jump to the bracket closing the container opened by cur
+        bool SkipContainer() noexcept
+        {
+            NestedSkip skip;
+            skip.Depth = 1;
+            while (true)
+            {
+                const string_char* stop = SkipNested(pos, end, skip);
+                if (skip.Depth == 0)
+                {
+                    pos = stop;
+                    cur = stop[-1];
+                    return true;
+                }
+                pos = stop;
+                if (stop != end || Peek() == 0)
+                    return ReportError(EJSON_TEXT("invalid skipped value"));
+            }
+        }
+
+        bool ParseArray() noexcept
+        {
+            EJSON_ASSERT(token == Token::SquaredOpen, "internal error");
+
+            if (ListenerSkips([&] { return listener->ArrayBegin(); }))
+                return SkipContainer();
+
+            if (!ParseNextToken())
+                return false;
+
+            while (true)
+            {
+                if (token == Token::SquaredClose)
+                {
+                    listener->ArrayEnd();
+                    return true;
+                }
+
+                if (!ParseValue())
+                    return false;
+
+                if (!ParseNextToken())
+                    return false;
+
+                if (token == Token::Comma)
+                {
+                    if (!ParseNextToken())
+                        return false;
+                }
+            }
+
+        }
+    };
+
+    // Tokens returned by JsonCursor::NextToken
+    enum class CursorToken : std::uint8_t
+    {
+        Error,
+        // the root value is done and only spaces follow it
+        End,
+        ObjectBegin,
+        ObjectEnd,
+        // a property name, see CurrentKey, its value is the next token
+        Key,
+        ArrayBegin,
+        ArrayEnd,
+        String,
+        Number,
+        True,
+        False,
+        Null
+    };
+
+    // Pull cursor on the JsonReader tokenizer: the caller asks for the next token instead of receiving listener
+    // callbacks, deserialization code can then read a field and decide what comes next in straight-line code:
+    //
+    //     JsonCursor cursor(stringReader);
+    //     if (!cursor.EnterObject())
+    //         return false;
+    //     while (cursor.NextToken() == CursorToken::Key)
+    //     {
+    //         if (cursor.CurrentKey() == EJSON_TEXT("id") && cursor.NextToken() == CursorToken::Number)
+    //             id = cursor.GetNumber();
+    //         else
+    //             cursor.SkipValue();
+    //     }
+    //     return !cursor.HaveError();
+    //
+    // Input is accepted and errors are reported the same as JsonReader, skipped values are jumped over without
+    // being tokenized. An error is final, NextToken then keeps returning CursorToken::Error.
+    template<typename STRING_READER>
+    class JsonCursor
+    {
+    public:
+
+        JsonCursor(STRING_READER& reader) noexcept
+            : jsonReader(listener, reader)
+        {}
+
+        CursorToken NextToken() noexcept
+        {
+            if (current != CursorToken::Error && current != CursorToken::End)
+                current = ReadToken();
+            return current;
+        }
+
+        // token returned by the last call to NextToken
+        CursorToken GetToken() const noexcept { return current; }
+
+        // name of the last Key token
+        string_view CurrentKey() const noexcept { return key; }
+
+        // text of the current String or Number token, valid until the next call to the cursor
+        string_view GetString() const noexcept { return jsonReader.text; }
+
+        number GetNumber() const noexcept
+        {
+            EJSON_ASSERT(current == CursorToken::Number, "expected token: number");
+            return jsonReader.numberToken.Value;
+        }
+
+        bool GetBool() const noexcept
+        {
+            EJSON_ASSERT(current == CursorToken::True || current == CursorToken::False, "expected token: bool");
+            return current == CursorToken::True;
+        }
+
+        // skips the current value: the value of the current Key or the rest of the object or array just begun,
+        // the current token is then the last token of the skipped value
+        bool SkipValue() noexcept
+        {
+            if (current == CursorToken::Key)
+                NextToken();
+            if (current == CursorToken::ObjectBegin || current == CursorToken::ArrayBegin)
+                return LeaveContainer();
+            return current != CursorToken::Error;
+        }
+
+        // reads the next token, an error if it does not begin an object
+        bool EnterObject() noexcept
+        {
+            return Expect(CursorToken::ObjectBegin, EJSON_TEXT("expected object"));
+        }
+
+        // skips what is left of the innermost object, the current token is then its ObjectEnd
+        bool LeaveObject() noexcept
+        {
+            EJSON_ASSERT(current == CursorToken::Error || (VectorSize(containers) != 0 && containers[VectorSize(containers) - 1] == Container::Object), "not in an object");
+            return LeaveContainer();
+        }
+
+        // reads the next token, an error if it does not begin an array
+        bool EnterArray() noexcept
+        {
+            return Expect(CursorToken::ArrayBegin, EJSON_TEXT("expected array"));
+        }
+
+        // skips what is left of the innermost array, the current token is then its ArrayEnd
+        bool LeaveArray() noexcept
+        {
+            EJSON_ASSERT(current == CursorToken::Error || (VectorSize(containers) != 0 && containers[VectorSize(containers) - 1] == Container::Array), "not in an array");
+            return LeaveContainer();
+        }
+
+        ParserError GetError() const noexcept { return jsonReader.GetError(); }
+        bool HaveError() const noexcept { return jsonReader.HaveError(); }
+
+    private:
+
+        // the tokenizer is used alone, callbacks are never called (NumberToken has numbers converted while scanned)
+        struct NoListener
+        {
+            void ObjectBegin() noexcept {}
+            void ObjectEnd() noexcept {}
+            void PropertyBegin(const string_view&) noexcept {}
+            void PropertyEnd() noexcept {}
+            void ArrayBegin() noexcept {}
+            void ArrayEnd() noexcept {}
+            void ValueBool(bool) noexcept {}
+            void ValueNull() noexcept {}
+            void ValueString(const string_view&) noexcept {}
+            void ValueNumber(const NumberToken&) noexcept {}
+        };
+
+        using Reader = JsonReader<NoListener, STRING_READER>;
+        using Token = typename Reader::Token;
+
+        enum class Container : std::uint8_t
+        {
+            Object,
+            Array
+        };
+
+        // what the next token may be, the same sequence JsonReader parses
+        enum class State : std::uint8_t
+        {
+            Value,
+            ObjectKey,
+            ObjectColon,
+            ObjectCommaOrEnd,
+            ArrayValueOrEnd,
+            ArrayCommaOrValue,
+            Done
+        };
+
+        NoListener listener;
+        Reader jsonReader;
+        vector<Container> containers;
+        State state = State::Value;
+        CursorToken current = CursorToken::Null;
+        string key;
+
+        CursorToken ReadToken() noexcept
+        {
+            switch (state)
+            {
+                case State::Value:
+                {
+                    if (!jsonReader.ParseNextToken())
+                        return CursorToken::Error;
+                    return OnValue();
+                }
+                case State::ObjectKey:
+                {
+                    return ReadKey();
+                }
+                case State::ObjectColon:
+                {
+                    if (!jsonReader.ParseNextToken())
+                        return CursorToken::Error;
+                    if (jsonReader.token != Token::Colon)
+                        return Fail(EJSON_TEXT("unexpected object property, missing ':'"));
+                    state = State::Value;
+                    return ReadToken();
+                }
+                case State::ObjectCommaOrEnd:
+                {
+                    if (!jsonReader.ParseNextToken())
+                        return CursorToken::Error;
+                    switch (jsonReader.token)
+                    {
+                        case Token::Comma:
+                            return ReadKey();
+                        case Token::CurlyClose:
+                            return OnContainerEnd();
+                        default:
+                            return Fail(EJSON_TEXT("unexpected token after object property"));
+                    }
+                }
+                case State::ArrayCommaOrValue:
+                {
+                    if (!jsonReader.ParseNextToken())
+                        return CursorToken::Error;
+                    // a missing comma is accepted like JsonReader does
+                    if (jsonReader.token == Token::Comma)
+                    {
+                        state = State::ArrayValueOrEnd;
+                        return ReadToken();
+                    }
+                    if (jsonReader.token == Token::SquaredClose)
+                        return OnContainerEnd();
+                    return OnValue();
+                }
+                case State::ArrayValueOrEnd:
+                {
+                    if (!jsonReader.ParseNextToken())
+                        return CursorToken::Error;
+                    if (jsonReader.token == Token::SquaredClose)
+                        return OnContainerEnd();
+                    return OnValue();
+                }
+                default:
+                {
+                    // only spaces may follow the root value
+                    jsonReader.Read();
+                    jsonReader.SkipSpaces();
+                    if (jsonReader.HaveError())
+                        return CursorToken::Error;
+                    if (jsonReader.cur != 0)
+                    {
+                        u32 line = 0;
+                        u32 column = 0;
+                        jsonReader.Locate(jsonReader.pos - 1, line, column);
+                        jsonReader.ReportError(EJSON_TEXT("invalid input after value"), line, column);
+                        return CursorToken::Error;
+                    }
+                    return CursorToken::End;
+                }
+            }
+        }
+
+        CursorToken ReadKey() noexcept
+        {
+            if (!jsonReader.ParseNextToken())
+                return CursorToken::Error;
+            if (jsonReader.token != Token::String)
+                return Fail(EJSON_TEXT("unexpected object property"));
+
+            // the name view does not outlive the next token
+            key = jsonReader.text;
+            state = State::ObjectColon;
+            return CursorToken::Key;
+        }
+
+        CursorToken OnValue() noexcept
+        {
+            switch (jsonReader.token)
+            {
+                case Token::CurlyOpen:
+                    VectorEmplace(containers, Container::Object);
+                    state = State::ObjectKey;
+                    return CursorToken::ObjectBegin;
+                case Token::SquaredOpen:
+                    VectorEmplace(containers, Container::Array);
+                    state = State::ArrayValueOrEnd;
+                    return CursorToken::ArrayBegin;
+                case Token::Number:
+                    OnValueEnd();
+                    return CursorToken::Number;
+                case Token::String:
+                    OnValueEnd();
+                    return CursorToken::String;
+                case Token::Null:
+                    OnValueEnd();
+                    return CursorToken::Null;
+                case Token::True:
+                    OnValueEnd();
+                    return CursorToken::True;
+                case Token::False:
+                    OnValueEnd();
+                    return CursorToken::False;
+                default:
+                    return Fail(EJSON_TEXT("unexpected value"));
+            }
+        }
+
+        CursorToken OnContainerEnd() noexcept
+        {
+            const Container container = containers[VectorSize(containers) - 1];
+            VectorRemoveLast(containers);
+            OnValueEnd();
+            return container == Container::Object ? CursorToken::ObjectEnd : CursorToken::ArrayEnd;
+        }
+
+        void OnValueEnd() noexcept
+        {
+            if (VectorSize(containers) == 0)
+                state = State::Done;
+            else if (containers[VectorSize(containers) - 1] == Container::Array)
+                state = State::ArrayCommaOrValue;
+            else
+                state = State::ObjectCommaOrEnd;
+        }
+
+        // raw skip to the bracket closing the innermost container
+        bool LeaveContainer() noexcept
+        {
+            if (current == CursorToken::Error || VectorSize(containers) == 0)
+                return false;
+            if (!jsonReader.SkipContainer())
+            {
+                current = CursorToken::Error;
+                return false;
+            }
+            current = OnContainerEnd();
+            return true;
+        }
+
+        bool Expect(CursorToken token, const string_char* msg) noexcept
+        {
+            if (NextToken() == token)
+                return true;
+            if (current != CursorToken::Error)
+                current = Fail(msg);
+            return false;
+        }
+
+        CursorToken Fail(const string_char* msg) noexcept
+        {
+            jsonReader.ReportError(msg);
+            return CursorToken::Error;
+        }
+    };
+
+    // StructuralIndex is the first stage of JsonIndexReader: it classifies the input 64 characters at a time
+    // and records the offset of every token boundary outside strings ('{', '}', '[', ']', ':', ',', both quotes
+    // of strings and the first character of numbers and literals). The input is indexed one window at a time
+    // so the parser finds the characters still in cache.
+    //
+    // A '\r' not followed by '\n' outside strings is indexed too (it is an error wherever it is read), the
+    // index stops at the first '\0' which ends the input for the readers. Blocks holding a '\\' or a '\r' are
+    // flagged, strings outside of those blocks are plain text between their two quotes.
+    class StructuralIndex
+    {
+    public:
+
+        StructuralIndex(string_view input) noexcept
+            : input(input), size(StringSize(input))
+        {
+            const size_t blocks = (size + SimdBlock::Size - 1) / SimdBlock::Size;
+            escapeBlocks.reset(new u64[blocks / 64 + 1]());
+        }
+
+        StructuralIndex(const StructuralIndex&) = delete;
+        StructuralIndex& operator=(const StructuralIndex&) = delete;
+        ~StructuralIndex() noexcept {}
+
+        // index the next window, false once the whole input is indexed
+        // offsets of a window are relative to Base() and stay valid until the next call
+        bool Next() noexcept
+        {
+            count = 0;
+            if (position >= size)
+                return false;
+
+            if (!offsets)
+                offsets.reset(new u32[WindowSize]);
+
+            base = position;
+            const size_t windowEnd = std::min(size, position + WindowSize);
+            string_char tail[SimdBlock::Size];
+
+            for (; position < windowEnd; position += SimdBlock::Size)
+            {
+                const string_char* chars = input.data() + position;
+                if (size - position < SimdBlock::Size)
+                {
+                    // pad the last block with spaces, they are neither indexed nor part of a token
+                    std::fill(tail, tail + SimdBlock::Size, EJSON_TEXT(' '));
+                    std::copy(chars, input.data() + size, tail);
+                    chars = tail;
+                }
+
+                const SimdBlock block(chars);
+                const u64 backslash = block.Equal('\\');
+                u64 escapes = backslash;
+                u64 lineEndings = 0;
+                u64 valid = ~0ull;
+
+                // '\0' and '\r' are rare, look at them closely only when the block has one
+                if (block.EqualAny(0, '\r') != 0)
+                {
+                    const u64 carriageReturn = block.Equal('\r');
+                    const bool nextIsNewline = position + SimdBlock::Size < size && input[position + SimdBlock::Size] == EJSON_TEXT('\n');
+                    lineEndings = carriageReturn & ~((block.Equal('\n') >> 1) | (nextIsNewline ? 1ull << 63 : 0));
+                    escapes |= carriageReturn;
+
+                    const u64 end = block.Equal(0);
+                    if (end != 0)
+                        valid = (1ull << std::countr_zero(end)) - 1;
+                }
+
+                if (escapes != 0)
+                    escapeBlocks[position / SimdBlock::Size / 64] |= 1ull << (position / SimdBlock::Size % 64);
+
+                const u64 quote = block.Equal('"');
+                const u64 realQuote = quote & ~FindEscaped(backslash, escapedCarry);
+                // opening quote and string content are inside, the closing quote is not
+                const u64 inside = PrefixXor(realQuote) ^ insideCarry;
+                insideCarry = (u64)((s64)inside >> 63);
+
+                const u64 space = block.EqualAny(' ', '\t', '\n', '\r');
+                const u64 operators = block.EqualAny('{', '}', '[', ']', ':', ',');
+                const u64 scalar = ~(operators | space | quote | inside);
+                const u64 scalarStart = scalar & ~((scalar << 1) | scalarCarry);
+                scalarCarry = scalar >> 63;
+
+                u64 structurals = (((operators | lineEndings) & ~inside) | realQuote | scalarStart) & valid;
+
+                u32* out = offsets.get() + count;
+                const u32 blockOffset = (u32)(position - base);
+                while (structurals != 0)
+                {
+                    *out++ = blockOffset + (u32)std::countr_zero(structurals);
+                    structurals &= structurals - 1;
+                }
+                count = (size_t)(out - offsets.get());
+
+                if (valid != ~0ull)
+                {
+                    position = size;
+                    break;
+                }
+            }
+
+            return true;
+        }
+
+        size_t Base() const noexcept { return base; }
+        const u32* begin() const noexcept { return offsets.get(); }
+        const u32* end() const noexcept { return offsets.get() + count; }
+
+        // true if a block overlapping the characters [begin, end) holds a '\\' or a '\r', only valid for indexed blocks
+        bool HasEscapes(size_t begin, size_t end) const noexcept
+        {
+            if (begin == end)
+                return false;
+            for (size_t block = begin / SimdBlock::Size; block <= (end - 1) / SimdBlock::Size; ++block)
+            {
+                if ((escapeBlocks[block / 64] >> (block % 64)) & 1)
+                    return true;
+            }
+            return false;
+        }
+
+    private:
+
+        static constexpr size_t WindowSize = 16 * 1024;
+
+        string_view input;
+        size_t size = 0;
+        size_t position = 0;
+        size_t base = 0;
+        u64 escapedCarry = 0;
+        u64 insideCarry = 0;
+        u64 scalarCarry = 0;
+        std::unique_ptr<u32[]> offsets;
+        size_t count = 0;
+        std::unique_ptr<u64[]> escapeBlocks;
+    };
+
+    // JsonIndexReader parses a whole buffer in two stages: StructuralIndex finds the token boundaries, then the
+    // parser walks the offsets instead of the characters. It reports the same LISTENER callbacks, results and
+    // errors as JsonReader does on the same input.
+    template<typename LISTENER>
+    class JsonIndexReader
+    {
+    public:
+
+        JsonIndexReader(LISTENER& listener, string_view input) noexcept
+            :listener(&listener), input(input), inputEnd(input.data() + StringSize(input)), index(input)
+        {}
+
+        bool Parse() noexcept
+        {
+            if (!ParseNextToken())
+                return false;
+
+            if (!ParseValue())
+                return false;
+
+            if (const string_char* extra = NextTokenStart())
+            {
+                if (*extra == L'\r')
+                    return ReportError(EJSON_TEXT("invalid line ending"));
+                return ReportError(EJSON_TEXT("invalid input after value"), extra);
+            }
+
+            return true;
+        }
+
+        ParserError GetError() const noexcept { return error; }
+        bool HaveError() const noexcept { return StringSize(error.Error) != 0; }
+
+    private:
+
+        enum class Token : std::uint8_t
+        {
+            Invalid,
+            CurlyOpen,
+            CurlyClose,
+            SquaredOpen,
+            SquaredClose,
+            Colon,
+            Comma,
+            String,
+            Number,
+            True,
+            False,
+            Null
+        };
+
+        LISTENER* listener = nullptr;
+        string_view input;
+        const string_char* inputEnd = nullptr;
+        StructuralIndex index;
+        // offsets of the current index window
+        const string_char* windowBase = nullptr;
+        const u32* next = nullptr;
+        const u32* last = nullptr;
+        Token token = Token::Invalid;
+        // first character of the current token, null before the first one
+        const string_char* tokenStart = nullptr;
+        // end of the current number or literal, the next token may follow it without separator
+        const string_char* scalarEnd = nullptr;
+        string_view text;
+        string value;
+        // converted number token, for listeners taking NumberToken
+        NumberToken numberToken;
+        ParserError error;
+
+        static bool IsScalar(string_char c) noexcept
+        {
+            switch (c)
+            {
+                case EJSON_TEXT(' '):
+                case EJSON_TEXT('\t'):
+                case EJSON_TEXT('\n'):
+                case EJSON_TEXT('\r'):
+                case EJSON_TEXT('{'):
+                case EJSON_TEXT('}'):
+                case EJSON_TEXT('['):
+                case EJSON_TEXT(']'):
+                case EJSON_TEXT(':'):
+                case EJSON_TEXT(','):
+                case EJSON_TEXT('"'):
+                case 0:
+                    return false;
+                default:
+                    return true;
+            }
+        }
+
+        // '\0' ends the input like it does for JsonReader
+        bool IsEnd(const string_char* p) const noexcept
+        {
+            return p == inputEnd || *p == 0;
+        }
+
+        // '\r' not followed by '\n'
+        bool IsInvalidLineEnding(const string_char* p) const noexcept
+        {
+            return *p == L'\r' && (p + 1 == inputEnd || p[1] != L'\n');
+        }
+
+        const string_char* PeekIndexed() noexcept
+        {
+            while (next == last)
+            {
+                if (!index.Next())
+                    return nullptr;
+                windowBase = input.data() + index.Base();
+                next = index.begin();
+                last = index.end();
+            }
+            return windowBase + *next;
+        }
+
+        // only the first character of a run of number and literal characters is indexed, tokens glued to a
+        // number or literal ("1-2", "truefalse") start where the previous one ends
+        const string_char* NextTokenStart() noexcept
+        {
+            const string_char* glued = scalarEnd;
+            scalarEnd = nullptr;
+            if (glued != nullptr && glued != inputEnd && IsScalar(*glued))
+                return glued;
+            const string_char* start = PeekIndexed();
+            if (start != nullptr)
+                ++next;
+            return start;
+        }
+
+        bool ReportError(const string_view& msg, const string_char* at = nullptr) noexcept
+        {
+            if (at == nullptr)
+                at = tokenStart;
+
+            if (at == nullptr)
+            {
+                error.Line = 1;
+                error.Column = 0;
+            }
+            else
+            {
+                u32 line = 1;
+                u32 lineChars = 0;
+                CountLines(input.data(), at, line, lineChars);
+                error.Line = line;
+                error.Column = lineChars + 1;
+            }
+            error.Error = msg;
+            return false;
+        }
+
+        bool ParseLiteral(const string_char* literal) noexcept
+        {
+            const string_char* p = tokenStart + 1;
+            size_t i = 1;
+            while (literal[i] != 0 && p != inputEnd && *p == literal[i])
+            {
+                ++i;
+                ++p;
+            }
+            scalarEnd = p;
+
+            if (literal[i] == 0)
+                return true;
+            else
+                return ReportError(EJSON_TEXT("expected: literal"));
+        }
+
+        bool ParseNumber() noexcept
+        {
+            if constexpr (ListensNumberTokens<LISTENER>)
+            {
+                // converted in the same pass, malformed numbers go through the checks below
+                const string_char* numberEnd = ParseNumberPrefix<false>(tokenStart, inputEnd, numberToken);
+                if (numberEnd != nullptr && numberEnd[-1] != EJSON_TEXT('.') && (numberEnd == inputEnd || *numberEnd != EJSON_TEXT('.')))
+                {
+                    scalarEnd = numberEnd;
+                    text = string_view(tokenStart, numberEnd - tokenStart);
+                    numberToken.Text = text;
+                    return true;
+                }
+            }
+
+            const string_char* p = tokenStart;
+
+            if (*p == L'-')
+            {
+                ++p;
+                if (IsEnd(p) || IsInvalidLineEnding(p))
+                    return ReportError(EJSON_TEXT("invalid number"));
+            }
+
+            bool valid = false;
+            for (; p != inputEnd && (IsDigit(*p) || *p == L'.'); ++p)
+            {
+                // cannot start with '.'
+                if (!valid && *p == L'.')
+                    return ReportError(EJSON_TEXT("invalid number"));
+                valid = true;
+            }
+            // cannot end with '.'
+            if (valid && p[-1] == L'.')
+                return ReportError(EJSON_TEXT("invalid number"));
+
+            scalarEnd = p;
+            text = string_view(tokenStart, p - tokenStart);
+            if constexpr (ListensNumberTokens<LISTENER>)
+                ::ejson::ParseNumber(text, numberToken);
+            return valid;
+        }
+
+        bool ParseString() noexcept
+        {
+            const string_char* begin = tokenStart + 1;
+
+            // the closing quote is the next offset, plain text if no escape or line ending can be in between
+            const string_char* close = PeekIndexed();
+            if (close != nullptr && !index.HasEscapes((size_t)(begin - input.data()), (size_t)(close - input.data())))
+            {
+                ++next;
+                text = string_view(begin, close - begin);
+                return true;
+            }
+
+            const string_char* p = begin;
+            bool lineEndings = false;
+
+            while (true)
+            {
+                p = ScanString(p, inputEnd);
+                if (IsEnd(p) || IsInvalidLineEnding(p))
+                    return ReportError(EJSON_TEXT("invalid string"));
+
+                if (*p == L'"')
+                    break;
+
+                if (*p == L'\\')
+                {
+                    const string_char escape = p + 1 != inputEnd ? p[1] : 0;
+                    if (escape != L'\"' &&
+                        escape != L'\\' &&
+                        escape != L'/' &&
+                        escape != L'b' &&
+                        escape != L'f' &&
+                        escape != L'n' &&
+                        escape != L'r' &&
+                        escape != L't' &&
+                        escape != L'u')
+                        return ReportError(EJSON_TEXT("invalid escape car"));
+
+                    p += 2;
+                    if (escape == L'u')
+                    {
+                        // must be followed by 4 numbers
+                        for (int i = 0; i < 4; ++i, ++p)
+                        {
+                            if (p == inputEnd || *p < L'0' || *p > '9')
+                                return ReportError(EJSON_TEXT("escape \\u in string must be followed by 4 numbers"));
+                        }
+                    }
+                }
+                else
+                {
+                    // control characters are kept, "\r\n" is read as '\n' like JsonReader does
+                    lineEndings |= *p == L'\r';
+                    ++p;
+                }
+            }
+
+            // valid escapes never hide a quote from the index, the closing quote is the next offset
+            const string_char* closingQuote = PeekIndexed();
+            EJSON_ASSERT(closingQuote == p, "internal error");
+            if (closingQuote != nullptr)
+                ++next;
+
+            // escapes are kept as written, only line endings make the text differ from the input
+            if (!lineEndings)
+            {
+                text = string_view(begin, p - begin);
+                return true;
+            }
+
+            StringClear(value);
+            for (const string_char* c = begin; c != p; ++c)
+            {
+                if (*c != L'\r')
+                    StringAdd(value, *c);
+            }
+            text = value;
+            return true;
+        }
+
+        bool ParseNextToken() noexcept
+        {
+            // the error is reported on the previous token when the input ends or has an invalid line ending
+            const string_char* start = NextTokenStart();
+            if (start == nullptr || *start == L'\r')
+                return ReportError(EJSON_TEXT("invalid token"));
+
+            tokenStart = start;
+            token = Token::Invalid;
+            switch (*start)
+            {
+                case EJSON_TEXT('{'):
+                {
+                    token = Token::CurlyOpen;
+                    return true;
+                }
+                case EJSON_TEXT('}'):
+                {
+                    token = Token::CurlyClose;
+                    return true;
+                }
+                case EJSON_TEXT('['):
+                {
+                    token = Token::SquaredOpen;
+                    return true;
+                }
+                case EJSON_TEXT(']'):
+                {
+                    token = Token::SquaredClose;
+                    return true;
+                }
+                case EJSON_TEXT(','):
+                {
+                    token = Token::Comma;
+                    return true;
+                }
+                case EJSON_TEXT(':'):
+                {
+                    token = Token::Colon;
+                    return true;
+                }
+                case '0':
+                case '1':
+                case '2':
+                case '3':
+                case '4':
+                case '5':
+                case '6':
+                case '7':
+                case '8':
+                case '9':
+                case '-':
+                {
+                    if (!ParseNumber())
+                        return false;
+                    token = Token::Number;
+                    return true;
+                }
+                case EJSON_TEXT('"'):
+                {
+                    if (!ParseString())
+                        return false;
+                    token = Token::String;
+                    return true;
+                }
+                case EJSON_TEXT('t'):
+                {
+                    if (!ParseLiteral(EJSON_TEXT("true")))
+                        return false;
+                    token = Token::True;
+                    return true;
+                }
+                case EJSON_TEXT('f'):
+                {
+                    if (!ParseLiteral(EJSON_TEXT("false")))
+                        return false;
+                    token = Token::False;
+                    return true;
+                }
+                case EJSON_TEXT('n'):
+                {
+                    if (!ParseLiteral(EJSON_TEXT("null")))
+                        return false;
+                    token = Token::Null;
+                    return true;
+                }
+                default:
+                    return ReportError(EJSON_TEXT("invalid token"));
+            }
+        }
+
+        bool ParseValue() noexcept
+        {
+            switch (token)
+            {
+                case Token::CurlyOpen:
+                    return ParseObject();
+                case Token::SquaredOpen:
+                    return ParseArray();
+                case Token::Number:
+                    if constexpr (ListensNumberTokens<LISTENER>)
+                        listener->ValueNumber(numberToken);
+                    else
+                        listener->ValueNumber(text);
+                    return true;
+                case Token::String:
+                    listener->ValueString(text);
+                    return true;
+                case Token::Null:
+                    listener->ValueNull();
+                    return true;
+                case Token::True:
+                    listener->ValueBool(true);
+                    return true;
+                case Token::False:
+                    listener->ValueBool(false);
+                    return true;
+                default:
+                    return ReportError(EJSON_TEXT("unexpected value"));
+            }
+        }
+
+        bool ParseObject() noexcept
+        {
+            EJSON_ASSERT(token == Token::CurlyOpen, "internal error");
+
+            if (ListenerSkips([&] { return listener->ObjectBegin(); }))
+                return SkipContainer();
+
+            while (true)
+            {
+                if (!ParseNextToken())
+                    return false;
+
+                switch (token)
+                {
+                    case Token::String:
+                    {
+                        if (!ParseProperty())
+                            return false;
+
+                        if (!ParseNextToken())
+                            return false;
+                        switch (token)
+                        {
+                            case Token::Comma:
+                                break;
+                            case Token::CurlyClose:
+                                listener->ObjectEnd();
+                                return true;
+                            default:
+                                return ReportError(EJSON_TEXT("unexpected token after object property"));
+                        }
+                        break;
+                    }
+                    default:
+                        return ReportError(EJSON_TEXT("unexpected object property"));
+                }
+            }
+        }
+
+        bool ParseProperty() noexcept
+        {
+            EJSON_ASSERT(token == Token::String, "internal error");
+
+            const bool skip = ListenerSkips([&] { return listener->PropertyBegin(text); });
+
+            if (!ParseNextToken())
+                return false;
+
+            if (token != Token::Colon)
+                return ReportError(EJSON_TEXT("unexpected object property, missing ':'"));
+
+            if (!ParseNextToken())
+                return false;
+
+            if (skip)
+                return SkipValue();
+
+            if (!ParseValue())
+                return false;
+
+            listener->PropertyEnd();
+            return true;
+        }
+
+        // a value without callbacks: containers are skipped on the index, scalars are already read
+        bool SkipValue() noexcept
+        {
+            switch (token)
+            {
+                case Token::CurlyOpen:
+                case Token::SquaredOpen:
+                    return SkipContainer();
+                case Token::Number:
+                case Token::String:
+                case Token::Null:
+                case Token::True:
+                case Token::False:
+                    return true;
+                default:
+                    return ReportError(EJSON_TEXT("unexpected value"));
+            }
+        }
+
+        // strings are not indexed inside, counting the indexed brackets finds the closing one
+        bool SkipContainer() noexcept
+        {
+            u32 depth = 1;
+            while (const string_char* start = PeekIndexed())
+            {
+                ++next;
+                switch (*start)
+                {
+                    case EJSON_TEXT('{'):
+                    case EJSON_TEXT('['):
+                        ++depth;
+                        break;
+                    case EJSON_TEXT('}'):
+                    case EJSON_TEXT(']'):
+                        if (--depth == 0)
+                            return true;
+                        break;
+                }
+            }
+            return ReportError(EJSON_TEXT("invalid skipped value"));
+        }
+
+        bool ParseArray() noexcept
+        {
+            EJSON_ASSERT(token == Token::SquaredOpen, "internal error");
+
+            if (ListenerSkips([&] { return listener->ArrayBegin(); }))
+                return SkipContainer();
+
+            if (!ParseNextToken())
+                return false;
+
+            while (true)
+            {
+                if (token == Token::SquaredClose)
+                {
+                    listener->ArrayEnd();
+                    return true;
+                }
+
+                if (!ParseValue())
+                    return false;
+
+                if (!ParseNextToken())
+                    return false;
+
+                if (token == Token::Comma)
+                {
+                    if (!ParseNextToken())
+                        return false;
+                }
+            }
+        }
+    };
+
+    enum class PushStatus : std::uint8_t
+    {
+        NeedMoreInput,
+        Done,
+        Error
+    };
+
+    // JsonPushReader parses json handed in chunks of any size: Feed() consumes a chunk and returns, LISTENER
+    // callbacks are fired as soon as tokens complete, Finish() tells the input ended. The container stack and
+    // the current token are kept between chunks, only a token split across chunks is copied. Results and
+    // errors are the same as JsonReader on the whole input.
+    //
+    // Done means the root value is complete, trailing whitespace can still be fed.
+    template<typename LISTENER>
+    class JsonPushReader
+    {
+    public:
+
+        JsonPushReader(LISTENER& listener) noexcept
+            :listener(&listener)
+        {}
+
+        PushStatus Feed(string_view chunk) noexcept
+        {
+            if (failed || ended)
+                return Status();
+
+            chunkBegin = chunk.data();
+            pos = chunkBegin;
+            end = chunkBegin + StringSize(chunk);
+            // a string or number split between chunks goes on
+            if (lexer != Lexer::Between && lexer != Lexer::Literal && lexer != Lexer::Skip)
+                runBegin = pos;
+
+            Scan();
+
+            if (!failed)
+                EndChunk();
+            return Status();
+        }
+
+        PushStatus Finish() noexcept
+        {
+            if (failed || ended)
+                return Status();
+
+            chunkBegin = pos = end = runBegin = nullptr;
+            ended = true;
+            Scan();
+            return Status();
+        }
+
+        ParserError GetError() const noexcept { return error; }
+        bool HaveError() const noexcept { return StringSize(error.Error) != 0; }
+
+    private:
+
+        enum class Token : std::uint8_t
+        {
+            Invalid,
+            CurlyOpen,
+            CurlyClose,
+            SquaredOpen,
+            SquaredClose,
+            Colon,
+            Comma,
+            String,
+            Number,
+            True,
+            False,
+            Null
+        };
+
+        // where the next character goes
+        enum class Lexer : std::uint8_t
+        {
+            Between,
+            String,
+            StringEscape,
+            StringUnicode,
+            NumberSign,
+            Number,
+            Literal,
+            // skipping a container a listener does not want
+            Skip
+        };
+
+        // what the next token means
+        enum class Expect : std::uint8_t
+        {
+            RootValue,
+            ArrayValueOrEnd,
+            ArrayCommaOrValue,
+            ObjectKey,
+            ObjectColon,
+            ObjectValue,
+            ObjectCommaOrEnd,
+            Trailing
+        };
+
+        enum class Container : std::uint8_t
+        {
+            Array,
+            Object
+        };
+
+        LISTENER* listener = nullptr;
+        vector<Container> containers;
+        Lexer lexer = Lexer::Between;
+        Expect expect = Expect::RootValue;
+        // current chunk, pos is the next character to process
+        const string_char* chunkBegin = nullptr;
+        const string_char* pos = nullptr;
+        const string_char* end = nullptr;
+        // start of the current token text in the chunk, what came in previous chunks is in value
+        const string_char* runBegin = nullptr;
+        bool copied = false;
+        string_view text;
+        string value;
+        // a chunk ended on '\r', the next character tells if it is a line ending
+        bool pendingReturn = false;
+        bool lastDot = false;
+        const string_char* literal = nullptr;
+        size_t literalIndex = 0;
+        Token literalToken = Token::Invalid;
+        int unicodeDigits = 0;
+        NestedSkip skip;
+        // PropertyBegin asked to skip the value
+        bool skipProperty = false;
+        // input ended by Finish() or a '\0'
+        bool ended = false;
+        bool failed = false;
+        ParserError error;
+        // position of chunkBegin, tokenStart is the current token while it is in the chunk
+        const string_char* tokenStart = nullptr;
+        u32 chunkLine = 1;
+        u32 chunkLineChars = 0;
+        u32 tokenLine = 1;
+        u32 tokenColumn = 0;
+
+        PushStatus Status() const noexcept
+        {
+            if (failed)
+                return PushStatus::Error;
+            if (expect == Expect::Trailing && lexer == Lexer::Between && !pendingReturn)
+                return PushStatus::Done;
+            return PushStatus::NeedMoreInput;
+        }
+
+        void EndChunk() noexcept
+        {
+            // the chunk goes away: keep the token text and count its lines
+            if (runBegin != nullptr)
+            {
+                StringAdd(value, runBegin, end);
+                copied = true;
+                runBegin = nullptr;
+            }
+            if (tokenStart != nullptr)
+            {
+                Locate(tokenStart, tokenLine, tokenColumn);
+                tokenStart = nullptr;
+            }
+            CountLines(chunkBegin, end, chunkLine, chunkLineChars);
+        }
+
+        void Locate(const string_char* p, u32& line, u32& column) const noexcept
+        {
+            u32 lineChars = chunkLineChars;
+            line = chunkLine;
+            CountLines(chunkBegin, p, line, lineChars);
+            column = lineChars + 1;
+        }
+
+        bool ReportError(const string_view& msg, const string_char* at = nullptr) noexcept
+        {
+            if (at != nullptr)
+            {
+                Locate(at, error.Line, error.Column);
+            }
+            else
+            {
+                if (tokenStart != nullptr)
+                {
+                    Locate(tokenStart, tokenLine, tokenColumn);
+                    tokenStart = nullptr;
+                }
+                error.Line = tokenLine;
+                error.Column = tokenColumn;
+            }
+            error.Error = msg;
+            failed = true;
+            return false;
+        }
+
+        // text of the finished string or number token, a view on the chunk unless it was split
+        void EndText() noexcept
+        {
+            if (!copied)
+            {
+                text = string_view(runBegin, pos - runBegin);
+            }
+            else
+            {
+                if (runBegin != nullptr)
+                    StringAdd(value, runBegin, pos);
+                text = value;
+            }
+            runBegin = nullptr;
+        }
+
+        void BeginText(const string_char* begin) noexcept
+        {
+            runBegin = begin;
+            copied = false;
+            StringClear(value);
+        }
+
+        void Scan() noexcept
+        {
+            if (pendingReturn)
+            {
+                pendingReturn = false;
+                const bool lineEnding = pos != end && *pos == L'\n';
+                if (lineEnding)
+                    ++pos;
+                if (!LineEnding(lineEnding))
+                    return;
+            }
+
+            bool more = true;
+            while (more)
+            {
+                switch (lexer)
+                {
+                    case Lexer::Between:
+                        more = ScanBetween();
+                        break;
+                    case Lexer::String:
+                        more = ScanString();
+                        break;
+                    case Lexer::StringEscape:
+                        more = ScanEscape();
+                        break;
+                    case Lexer::StringUnicode:
+                        more = ScanUnicode();
+                        break;
+                    case Lexer::NumberSign:
+                        more = ScanNumberSign();
+                        break;
+                    case Lexer::Number:
+                        more = ScanNumber();
+                        break;
+                    case Lexer::Literal:
+                        more = ScanLiteral();
+                        break;
+                    case Lexer::Skip:
+                        more = ScanSkip();
+                        break;
+                }
+            }
+        }
+
+        // '\r' was consumed, it must be followed by '\n'
+        bool ReturnChar() noexcept
+        {
+            if (pos == end && !ended)
+            {
+                pendingReturn = true;
+                return false;
+            }
+            const bool lineEnding = pos != end && *pos == L'\n';
+            if (lineEnding)
+                ++pos;
+            return LineEnding(lineEnding);
+        }
+
+        bool LineEnding(bool valid) noexcept
+        {
+            switch (lexer)
+            {
+                case Lexer::String:
+                {
+                    if (!valid)
+                        return ReportError(EJSON_TEXT("invalid string"));
+                    // "\r\n" is read as '\n'
+                    StringAdd(value, EJSON_TEXT('\n'));
+                    copied = true;
+                    runBegin = pos;
+                    return true;
+                }
+                case Lexer::NumberSign:
+                {
+                    if (!valid)
+                        return ReportError(EJSON_TEXT("invalid number"));
+                    // the '\n' doesn't start a number, JsonReader fails without message
+                    failed = true;
+                    return false;
+                }
+                default:
+                {
+                    if (valid)
+                        return true;
+                    if (expect == Expect::Trailing)
+                        return ReportError(EJSON_TEXT("invalid line ending"));
+                    return ReportError(EJSON_TEXT("invalid token"));
+                }
+            }
+        }
+
+        bool ScanBetween() noexcept
+        {
+            pos = SkipWhitespaces(pos, end);
+
+            if (pos != end && *pos == 0)
+            {
+                // '\0' ends the input
+                ended = true;
+                pos = end;
+            }
+
+            if (pos == end)
+            {
+                if (ended && expect != Expect::Trailing)
+                    return ReportError(EJSON_TEXT("invalid token"));
+                return false;
+            }
+
+            const string_char* start = pos++;
+            const string_char c = *start;
+
+            if (c == L'\r')
+                return ReturnChar();
+
+            if (expect == Expect::Trailing)
+                return ReportError(EJSON_TEXT("invalid input after value"), start);
+
+            tokenStart = start;
+            switch (c)
+            {
+                case EJSON_TEXT('{'):
+                    return OnToken(Token::CurlyOpen);
+                case EJSON_TEXT('}'):
+                    return OnToken(Token::CurlyClose);
+                case EJSON_TEXT('['):
+                    return OnToken(Token::SquaredOpen);
+                case EJSON_TEXT(']'):
+                    return OnToken(Token::SquaredClose);
+                case EJSON_TEXT(','):
+                    return OnToken(Token::Comma);
+                case EJSON_TEXT(':'):
+                    return OnToken(Token::Colon);
+                case '0':
+                case '1':
+                case '2':
+                case '3':
+                case '4':
+                case '5':
+                case '6':
+                case '7':
+                case '8':
+                case '9':
+                {
+                    BeginText(start);
+                    lastDot = false;
+                    lexer = Lexer::Number;
+                    return true;
+                }
+                case '-':
+                {
+                    BeginText(start);
+                    lexer = Lexer::NumberSign;
+                    return true;
+                }
+                case EJSON_TEXT('"'):
+                {
+                    BeginText(pos);
+                    lexer = Lexer::String;
+                    return true;
+                }
+                case EJSON_TEXT('t'):
+                    return BeginLiteral(EJSON_TEXT("true"), Token::True);
+                case EJSON_TEXT('f'):
+                    return BeginLiteral(EJSON_TEXT("false"), Token::False);
+                case EJSON_TEXT('n'):
+                    return BeginLiteral(EJSON_TEXT("null"), Token::Null);
+                default:
+                    return ReportError(EJSON_TEXT("invalid token"));
+            }
+        }
+
+        bool BeginLiteral(const string_char* literalText, Token token) noexcept
+        {
+            literal = literalText;
+            literalIndex = 1;
+            literalToken = token;
+            lexer = Lexer::Literal;
+            return true;
+        }
+
+        bool ScanLiteral() noexcept
+        {
+            for (; pos != end; ++pos)
+            {
+                if (*pos != literal[literalIndex])
+                    return ReportError(EJSON_TEXT("expected: literal"));
+                if (literal[++literalIndex] == 0)
+                {
+                    ++pos;
+                    lexer = Lexer::Between;
+                    return OnToken(literalToken);
+                }
+            }
+            if (!ended)
+                return false;
+            return ReportError(EJSON_TEXT("expected: literal"));
+        }
+
+        bool ScanSkip() noexcept
+        {
+            pos = SkipNested(pos, end, skip);
+            if (skip.Depth == 0)
+            {
+                lexer = Lexer::Between;
+                return OnSkipEnd();
+            }
+            if (pos != end)
+            {
+                // '\0' ends the input
+                ended = true;
+                return ReportError(EJSON_TEXT("invalid skipped value"));
+            }
+            if (ended)
+                return ReportError(EJSON_TEXT("invalid skipped value"));
+            return false;
+        }
+
+        bool BeginSkip() noexcept
+        {
+            skip = NestedSkip();
+            skip.Depth = 1;
+            lexer = Lexer::Skip;
+            return true;
+        }
+
+        // a skipped property gets no PropertyEnd
+        bool OnSkipEnd() noexcept
+        {
+            if (skipProperty)
+            {
+                skipProperty = false;
+                expect = Expect::ObjectCommaOrEnd;
+                return true;
+            }
+            return OnValueEnd();
+        }
+
+        bool ScanNumberSign() noexcept
+        {
+            if (pos == end)
+            {
+                if (!ended)
+                    return false;
+                return ReportError(EJSON_TEXT("invalid number"));
+            }
+
+            // JsonReader reads the character following '-' whatever it is
+            const string_char c = *pos++;
+            if (c == L'\r')
+                return ReturnChar();
+            if (c == 0)
+                return ReportError(EJSON_TEXT("invalid number"));
+            if (c == L'.')
+                return ReportError(EJSON_TEXT("invalid number"));
+            if (!IsDigit(c))
+            {
+                failed = true;
+                return false;
+            }
+            lastDot = false;
+            lexer = Lexer::Number;
+            return true;
+        }
+
+        bool ScanNumber() noexcept
+        {
+            for (; pos != end; ++pos)
+            {
+                if (IsDigit(*pos))
+                    lastDot = false;
+                else if (*pos == L'.')
+                    lastDot = true;
+                else
+                    break;
+            }
+            if (pos == end && !ended)
+                return false;
+
+            // cannot end with '.'
+            if (lastDot)
+                return ReportError(EJSON_TEXT("invalid number"));
+
+            EndText();
+            lexer = Lexer::Between;
+            return OnToken(Token::Number);
+        }
+
+        bool ScanString() noexcept
+        {
+            while (true)
+            {
+                pos = ejson::ScanString(pos, end);
+                if (pos == end)
+                {
+                    if (!ended)
+                        return false;
+                    return ReportError(EJSON_TEXT("invalid string"));
+                }
+
+                const string_char c = *pos;
+                if (c == L'"')
+                {
+                    EndText();
+                    ++pos;
+                    lexer = Lexer::Between;
+                    return OnToken(Token::String);
+                }
+
+                if (c == L'\\')
+                {
+                    ++pos;
+                    lexer = Lexer::StringEscape;
+                    return true;
+                }
+
+                if (c == 0)
+                    return ReportError(EJSON_TEXT("invalid string"));
+
+                if (c == L'\r')
+                {
+                    StringAdd(value, runBegin, pos);
+                    copied = true;
+                    runBegin = nullptr;
+                    ++pos;
+                    return ReturnChar();
+                }
+
+                // other control characters are kept
+                ++pos;
+            }
+        }
+
+        bool ScanEscape() noexcept
+        {
+            if (pos == end)
             {
-                case EJSON_TEXT('{'):
+                if (!ended)
+                    return false;
+                return ReportError(EJSON_TEXT("invalid escape car"));
+            }
+
+            const string_char escape = *pos;
+            if (escape != L'\"' &&
+                escape != L'\\' &&
+                escape != L'/' &&
+                escape != L'b' &&
+                escape != L'f' &&
+                escape != L'n' &&
+                escape != L'r' &&
+                escape != L't' &&
+                escape != L'u')
+                return ReportError(EJSON_TEXT("invalid escape car"));
+
+            ++pos;
+            if (escape == L'u')
+            {
+                unicodeDigits = 4;
+                lexer = Lexer::StringUnicode;
+            }
+            else
+            {
+                lexer = Lexer::String;
+            }
+            return true;
+        }
+
+        bool ScanUnicode() noexcept
+        {
+            // must be followed by 4 numbers
+            for (; unicodeDigits != 0; --unicodeDigits, ++pos)
+            {
+                if (pos == end)
                 {
-                    token = Token::CurlyOpen;
-                    return true;
+                    if (!ended)
+                        return false;
+                    return ReportError(EJSON_TEXT("escape \\u in string must be followed by 4 numbers"));
                 }
-                case EJSON_TEXT('}'):
+                if (!IsDigit(*pos))
+                    return ReportError(EJSON_TEXT("escape \\u in string must be followed by 4 numbers"));
+            }
+            lexer = Lexer::String;
+            return true;
+        }
+
+        bool OnToken(Token token) noexcept
+        {
+            switch (expect)
+            {
+                case Expect::RootValue:
+                    return OnValue(token);
+
+                case Expect::ObjectValue:
                 {
-                    token = Token::CurlyClose;
-                    return true;
+                    if (!skipProperty)
+                        return OnValue(token);
+
+                    switch (token)
+                    {
+                        case Token::CurlyOpen:
+                        case Token::SquaredOpen:
+                            return BeginSkip();
+                        case Token::Number:
+                        case Token::String:
+                        case Token::Null:
+                        case Token::True:
+                        case Token::False:
+                            return OnSkipEnd();
+                        default:
+                            return ReportError(EJSON_TEXT("unexpected value"));
+                    }
                 }
-                case EJSON_TEXT('['):
+
+                case Expect::ArrayCommaOrValue:
                 {
-                    token = Token::SquaredOpen;
-                    return true;
+                    // a missing comma is accepted like JsonReader does
+                    if (token == Token::Comma)
+                    {
+                        expect = Expect::ArrayValueOrEnd;
+                        return true;
+                    }
+                    [[fallthrough]];
                 }
-                case EJSON_TEXT(']'):
+                case Expect::ArrayValueOrEnd:
                 {
-                    token = Token::SquaredClose;
-                    return true;
+                    if (token == Token::SquaredClose)
+                    {
+                        listener->ArrayEnd();
+                        VectorRemoveLast(containers);
+                        return OnValueEnd();
+                    }
+                    return OnValue(token);
                 }
-                case EJSON_TEXT(','):
+
+                case Expect::ObjectKey:
                 {
-                    token = Token::Comma;
+                    if (token != Token::String)
+                        return ReportError(EJSON_TEXT("unexpected object property"));
+                    skipProperty = ListenerSkips([&] { return listener->PropertyBegin(text); });
+                    expect = Expect::ObjectColon;
                     return true;
                 }
-                case EJSON_TEXT(':'):
+
+                case Expect::ObjectColon:
                 {
-                    token = Token::Colon;
+                    if (token != Token::Colon)
+                        return ReportError(EJSON_TEXT("unexpected object property, missing ':'"));
+                    expect = Expect::ObjectValue;
                     return true;
                 }
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                case '-':
+
+                case Expect::ObjectCommaOrEnd:
                 {
-                    if (!ParseNumber())
-                        return false;
-                    token = Token::Number;
-                    return true;
+                    switch (token)
+                    {
+                        case Token::Comma:
+                            expect = Expect::ObjectKey;
+                            return true;
+                        case Token::CurlyClose:
+                            listener->ObjectEnd();
+                            VectorRemoveLast(containers);
+                            return OnValueEnd();
+                        default:
+                            return ReportError(EJSON_TEXT("unexpected token after object property"));
+                    }
                 }
-                case EJSON_TEXT('"'):
-                {
-                    if (!ParseString())
-                        return false;
-                    token = Token::String;
+
+                default:
+                    return ReportError(EJSON_TEXT("invalid input after value"));
+            }
+        }
+
+        bool OnValue(Token token) noexcept
+        {
+            switch (token)
+            {
+                case Token::CurlyOpen:
+                    if (ListenerSkips([&] { return listener->ObjectBegin(); }))
+                        return BeginSkip();
+                    VectorEmplace(containers, Container::Object);
+                    expect = Expect::ObjectKey;
                     return true;
-                }
-                case EJSON_TEXT('t'):
-                {
-                    if (!ParseLiteral(EJSON_TEXT("true")))
-                        return false;
-                    token = Token::True;
+                case Token::SquaredOpen:
+                    if (ListenerSkips([&] { return listener->ArrayBegin(); }))
+                        return BeginSkip();
+                    VectorEmplace(containers, Container::Array);
+                    expect = Expect::ArrayValueOrEnd;
                     return true;
-                }
-                case EJSON_TEXT('f'):
+                case Token::Number:
+                    if constexpr (ListensNumberTokens<LISTENER>)
+                    {
+                        NumberToken numberToken;
+                        ::ejson::ParseNumber(text, numberToken);
+                        listener->ValueNumber(numberToken);
+                    }
+                    else
+                    {
+                        listener->ValueNumber(text);
+                    }
+                    return OnValueEnd();
+                case Token::String:
+                    listener->ValueString(text);
+                    return OnValueEnd();
+                case Token::Null:
+                    listener->ValueNull();
+                    return OnValueEnd();
+                case Token::True:
+                    listener->ValueBool(true);
+                    return OnValueEnd();
+                case Token::False:
+                    listener->ValueBool(false);
+                    return OnValueEnd();
+                default:
+                    return ReportError(EJSON_TEXT("unexpected value"));
+            }
+        }
+
+        bool OnValueEnd() noexcept
+        {
+            const size_t depth = VectorSize(containers);
+            if (depth == 0)
+            {
+                expect = Expect::Trailing;
+            }
+            else if (containers[depth - 1] == Container::Array)
+            {
+                expect = Expect::ArrayCommaOrValue;
+            }
+            else
+            {
+                listener->PropertyEnd();
+                expect = Expect::ObjectCommaOrEnd;
+            }
+            return true;
+        }
+    };
+
+    template<typename STRING_WRITER, bool PRETTIFY = false>
+    class JsonWriter
+    {
+    public:
+
+        JsonWriter(STRING_WRITER& writer) noexcept
+            : writer(&writer)
+        {
+            PushState(StateType::Root);
+        }
+
+        void WriteNull() noexcept
+        {
+            WriteValueBegin();
+            writer->Write(EJSON_TEXT("null"));
+            WriteValueEnd();
+        }
+
+        void WriteBool(bool value) noexcept
+        {
+            WriteValueBegin();
+            writer->Write(value ? EJSON_TEXT("true") : EJSON_TEXT("false"));
+            WriteValueEnd();
+        }
+
+        void WriteNumber(number value) noexcept
+        {
+            WriteValueBegin();
+            string_char text[FormatNumberSize];
+            writer->Write(string_view(text, FormatNumber(value, text) - text));
+            WriteValueEnd();
+        }
+
+        void WriteInt64(s64 value) noexcept
+        {
+            WriteValueBegin();
+            string_char digits[20];
+            string_char* begin = FormatInteger(value < 0 ? 0 - (u64)value : (u64)value, digits + 20);
+            if (value < 0)
+                *--begin = EJSON_TEXT('-');
+            writer->Write(string_view(begin, digits + 20 - begin));
+            WriteValueEnd();
+        }
+
+        void WriteUInt64(u64 value) noexcept
+        {
+            WriteValueBegin();
+            string_char digits[20];
+            string_char* begin = FormatInteger(value, digits + 20);
+            writer->Write(string_view(begin, digits + 20 - begin));
+            WriteValueEnd();
+        }
+
+        // ascii text of a number, written as is
+        void WriteNumberText(const c_string_view& text) noexcept
+        {
+            WriteValueBegin();
+            if constexpr (sizeof(string_char) == 1)
+            {
+                writer->Write(text);
+            }
+            else
+            {
+                string_char wide[64];
+                for (size_t i = 0; i < StringSize(text); i += 64)
                 {
-                    if (!ParseLiteral(EJSON_TEXT("false")))
-                        return false;
-                    token = Token::False;
-                    return true;
+                    const size_t size = std::min<size_t>(64, StringSize(text) - i);
+                    for (size_t j = 0; j < size; ++j)
+                        wide[j] = (string_char)text[i + j];
+                    writer->Write(string_view(wide, size));
                 }
-                case EJSON_TEXT('n'):
+            }
+            WriteValueEnd();
+        }
+
+        template <typename STR_TYPE>
+        void WriteString(const STR_TYPE& value) noexcept
+        {
+            WriteValueBegin();
+            writer->Write(EJSON_TEXT("\""));
+            writer->Write(value);
+            writer->Write(EJSON_TEXT("\""));
+            WriteValueEnd();
+        }
+
+        void WriteObjectBegin() noexcept
+        {
+            WriteValueBegin();
+            WriteContainerBegin();
+            PushState(StateType::Object);
+            writer->Write(EJSON_TEXT("{"));
+        }
+
+        void WriteObjectEnd() noexcept
+        {
+            EJSON_ASSERT(GetState().Type == StateType::Object, "internal error");
+            WriteContainerEnd();
+            writer->Write(EJSON_TEXT("}"));
+            WriteValueEnd();
+        }
+
+        template <typename STR_TYPE>
+        void WriteProperty(const STR_TYPE& name) noexcept
+        {
+            State& root = GetState();
+            EJSON_ASSERT(root.Type == StateType::Object, "internal error");
+            WriteValuePrefix();
+            PushState(StateType::Property);
+            writer->Write(EJSON_TEXT("\""));
+            writer->Write(name);
+            writer->Write(EJSON_TEXT("\""));
+            writer->Write(EJSON_TEXT(":"));
+            if constexpr (PRETTIFY)
+                writer->Write(EJSON_TEXT(" "));
+        }
+
+        void WriteArrayBegin() noexcept
+        {
+            WriteValueBegin();
+            WriteContainerBegin();
+            PushState(StateType::Array);
+            writer->Write(EJSON_TEXT("["));
+        }
+
+        void WriteArrayEnd() noexcept
+        {
+            EJSON_ASSERT(GetState().Type == StateType::Array, "internal error");
+            WriteContainerEnd();
+            writer->Write(EJSON_TEXT("]"));
+            WriteValueEnd();
+        }
+
+    private:
+
+        enum class StateType : std::uint8_t
+        {
+            Root,
+            Value,
+            Object,
+            Property,
+            Array,
+        };
+
+        struct State
+        {
+            std::int16_t Indentation = 0;
+            std::int16_t Count = 0;
+            StateType Type = StateType::Root;
+        };
+
+        void WriteIndentation() noexcept
+        {
+            static_assert(PRETTIFY);
+            for (int i = 0; i < indentation; ++i)
+                writer->Write(tab);
+        }
+
+        void WriteValuePrefix() noexcept
+        {
+            if (GetState().Count != 0)
+                writer->Write(EJSON_TEXT(","));
+            if constexpr (PRETTIFY)
+            {
+                if (GetState().Type != StateType::Root)
                 {
-                    if (!ParseLiteral(EJSON_TEXT("null")))
-                        return false;
-                    token = Token::Null;
-                    return true;
+                    writer->Write(EJSON_TEXT("\n"));
+                    WriteIndentation();
                 }
-                default:
-                    return ReportError(EJSON_TEXT("invalid token"));
             }
         }
 
-        bool ParseValue() noexcept
+        void WriteValueBegin() noexcept
         {
-            switch (token)
+            State& state = GetState();
+            EJSON_ASSERT(state.Type == StateType::Property || state.Type == StateType::Array || state.Type == StateType::Root, "internal error");
+            EJSON_ASSERT(state.Type != StateType::Root || state.Count == 0, "Json root may contain only one value");
+            State& root = state.Type == StateType::Property ? GetState(1) : GetState();
+            if (state.Type != StateType::Property)
             {
-                case Token::CurlyOpen:
-                    return ParseObject();
-                case Token::SquaredOpen:
-                    return ParseArray();
-                case Token::Number:
-                    listener->ValueNumber(value);
-                    return true;
-                case Token::String:
-                    listener->ValueString(value);
-                    return true;
-                case Token::Null:
-                    listener->ValueNull();
-                    return true;
-                case Token::True:
-                    listener->ValueBool(true);
-                    return true;
-                case Token::False:
-                    listener->ValueBool(false);
-                    return true;
-                default:
-                    return ReportError(EJSON_TEXT("unexpected value"));
+                WriteValuePrefix();
             }
+            ++root.Count;
+            PushState(StateType::Value);
         }
 
-        bool ParseObject() noexcept
+        void WriteValueEnd() noexcept
         {
-            EJSON_ASSERT(token == Token::CurlyOpen, "internal error");
+            EJSON_ASSERT(GetState().Type == StateType::Value, "internal error");
+            PopState();
+            if (GetState().Type == StateType::Property)
+                PopState();
+        }
 
-            listener->ObjectBegin();
+        void WriteContainerBegin() noexcept
+        {
+            if constexpr (PRETTIFY)
+                ++indentation;
+        }
 
-            while (true)
+        void WriteContainerEnd() noexcept
+        {
+            if constexpr (PRETTIFY)
             {
-                if (!ParseNextToken())
-                    return false;
+                const std::int16_t previousCount = GetState().Count;
+                if (previousCount != 0)
+                    writer->Write(EJSON_TEXT("\n"));
+                PopState();
+                --indentation;
+                if (previousCount != 0)
+                    WriteIndentation();
+            }
+            else
+            {
+                PopState();
+            }
+        }
 
-                switch (token)
-                {
-                    case Token::String:
-                    {
-                        if (!ParseProperty())
-                            return false;
+        void PushState(StateType type) noexcept
+        {
+            VectorEmplace(states, State{ 0,0,type });
+        }
 
-                        if (!ParseNextToken())
-                            return false;
-                        switch (token)
-                        {
-                            case Token::Comma:
-                                break;
-                            case Token::CurlyClose:
-                                listener->ObjectEnd();
-                                return true;
-                            default:
-                                return ReportError(EJSON_TEXT("unexpected token after object property"));
-                        }
-                        break;
-                    }
-                    default:
-                        return ReportError(EJSON_TEXT("unexpected object property"));
-                }
-            }
+        void PopState() noexcept
+        {
+            EJSON_ASSERT(VectorSize(states) > 0, "internal error");
+            VectorRemoveLast(states);
         }
 
-        bool ParseProperty() noexcept
+        State& GetState(size_t depth = 0) noexcept
         {
-            EJSON_ASSERT(token == Token::String, "internal error");
+            EJSON_ASSERT(VectorSize(states) > 0, "internal error");
+            return states[VectorSize(states) - (1 + depth)];
+        }
 
-            listener->PropertyBegin(value);
+        vector<State> states;
+        STRING_WRITER* writer = nullptr;
+        std::int32_t indentation = 0;
+        const string_char* tab = EJSON_TEXT("    ");
+    };
 
-            if (!ParseNextToken())
-                return false;
+    class StringReader
+    {
+    public:
 
-            if (token != Token::Colon)
-                return ReportError(EJSON_TEXT("unexpected object property, missing ':'"));
+        StringReader(string_view str, bool owner = false) noexcept
+        {
+            if (owner)
+            {
+                string = str;
+                stringView = string;
+            }
+            else
+            {
+                stringView = str;
+            }
+        }
 
-            if (!ParseNextToken())
+        StringReader(const StringReader&) = delete;
+        StringReader& operator=(const StringReader&) = delete;
+        ~StringReader() {}
+
+        static constexpr bool StableSpans = true;
+
+        bool Fill(const string_char*& begin, const string_char*& end) noexcept
+        {
+            if (position == StringSize(stringView))
                 return false;
-            if (!ParseValue())
+
+            begin = stringView.data() + position;
+            end = stringView.data() + StringSize(stringView);
+            position = StringSize(stringView);
+            return true;
+        }
+
+        bool Read(string_char& car) noexcept
+        {
+            if (position < StringSize(stringView))
+            {
+                car = stringView[position];
+                ++position;
+                return true;
+            }
+            else
+            {
                 return false;
+            }
+        }
 
-            listener->PropertyEnd();
+    private:
+
+        string string;
+        string_view stringView;
+        size_t position = 0;
+    };
+
+    class StringWriter
+    {
+
+    public:
+
+        StringWriter() noexcept
+        {
+            string = &stringData;
+        }
+
+        StringWriter(string& str) noexcept
+            : string(&str)
+        {}
+
+        StringWriter(const StringWriter&) = delete;
+        StringWriter& operator=(const StringWriter&) = delete;
+
+        ~StringWriter() noexcept {}
+
+
+        bool Write(string_char car) noexcept
+        {
+            StringAdd(*string, car);
+            return true;
+        }
+
+#if EJSON_WCHAR
+        size_t Write(const c_string_view& str) noexcept
+        {
+            w_string wstr;
+            StringConvert(str, wstr);
+            StringAdd(*string, wstr);
+            return StringSize(wstr);
+        }
+        size_t Write(const w_string_view& str) noexcept
+        {
+            StringAdd(*string, ::ejson::string(str));
+            return StringSize(str);
+        }
+#else
+        size_t Write(const c_string_view& str) noexcept
+        {
+            StringAdd(*string, ::ejson::string(str));
+            return StringSize(str);
+        }
+
+        size_t Write(const w_string_view& str) noexcept
+        {
+            c_string cstr;
+            StringConvert(str, cstr);
+            StringAdd(*string, cstr);
+            return StringSize(cstr);
+        }
+#endif
+
+        string ToString() const noexcept { return *string; }
+
+    private:
+
+        string stringData;
+        string* string = nullptr;
+    };
+
+    class StreamReader
+    {
+    public:
+
+        StreamReader(input_stream& stream) noexcept
+            : stream(stream)
+        {}
+
+        StreamReader(const StreamReader&) = delete;
+        StreamReader& operator=(const StreamReader&) = delete;
+        ~StreamReader() noexcept {}
+
+        bool Fill(const string_char*& begin, const string_char*& end) noexcept
+        {
+            if (position < size)
+            {
+                // leftover from per char reads
+                begin = buffer + position;
+            }
+            else
+            {
+                stream.read(buffer, BufferSize);
+                size = (size_t)stream.gcount();
+                if (size == 0)
+                    return false;
+                begin = buffer;
+            }
+            end = buffer + size;
+            position = size;
             return true;
         }
 
-        bool ParseArray() noexcept
+        bool Read(string_char& car) noexcept
         {
-            EJSON_ASSERT(token == Token::SquaredOpen, "internal error");
-
-            listener->ArrayBegin();
-
-            if (!ParseNextToken())
-                return false;
-
-            while (true)
+            if (position == size)
             {
-                if (token == Token::SquaredClose)
-                {
-                    listener->ArrayEnd();
-                    return true;
-                }
-
-                if (!ParseValue())
+                const string_char* begin;
+                const string_char* end;
+                if (!Fill(begin, end))
                     return false;
+                position = 0;
+            }
+            car = buffer[position];
+            ++position;
+            return true;
+        }
 
-                if (!ParseNextToken())
-                    return false;
+    private:
 
-                if (token == Token::Comma)
-                {
-                    if (!ParseNextToken())
-                        return false;
-                }
-            }
+        static constexpr size_t BufferSize = 4096;
 
-        }
+        input_stream& stream;
+        string_char buffer[BufferSize];
+        size_t size = 0;
+        size_t position = 0;
     };
 
-    template<typename STRING_WRITER, bool PRETTIFY = false>
-    class JsonWriter
+    // Decodes UTF-8 to wchar_t (UTF-16 surrogate pairs when wchar_t is 2 bytes) one chunk at a time: a sequence
+    // cut at the end of a chunk is completed by the next one. Invalid or truncated sequences give U+FFFD.
+    class Utf8Decoder
     {
     public:
 
-        JsonWriter(STRING_WRITER& writer) noexcept
-            : writer(&writer)
+        // output needs room for count + 1 characters (a 4 bytes sequence gives at most 2), returns the size written
+        size_t Decode(const char* bytes, size_t count, wchar_t* output) noexcept
         {
-            PushState(StateType::Root);
+            wchar_t* out = output;
+            const char* end = bytes + count;
+            while (bytes != end)
+            {
+                const u8 byte = (u8)*bytes;
+                if (remaining == 0)
+                {
+                    ++bytes;
+                    if (byte < 0x80)
+                    {
+                        *out++ = (wchar_t)byte;
+                        continue;
+                    }
+                    if (byte >= 0xC2 && byte < 0xE0)
+                        Start(byte & 0x1F, 1, 0x80);
+                    else if (byte >= 0xE0 && byte < 0xF0)
+                        Start(byte & 0x0F, 2, 0x800);
+                    else if (byte >= 0xF0 && byte < 0xF5)
+                        Start(byte & 0x07, 3, 0x10000);
+                    else
+                        *out++ = Replacement;
+                }
+                else if ((byte & 0xC0) == 0x80)
+                {
+                    ++bytes;
+                    codePoint = (codePoint << 6) | (byte & 0x3F);
+                    if (--remaining == 0)
+                        out = Put(out, codePoint);
+                }
+                else
+                {
+                    // truncated sequence, this byte starts again
+                    remaining = 0;
+                    *out++ = Replacement;
+                }
+            }
+            return (size_t)(out - output);
         }
 
-        void WriteNull() noexcept
+        // end of input, a pending sequence gives U+FFFD: returns the size written (0 or 1)
+        size_t Finish(wchar_t* output) noexcept
         {
-            WriteValueBegin();
-            writer->Write(EJSON_TEXT("null"));
-            WriteValueEnd();
+            if (remaining == 0)
+                return 0;
+            remaining = 0;
+            *output = Replacement;
+            return 1;
         }
 
-        void WriteBool(bool value) noexcept
+    private:
+
+        static constexpr wchar_t Replacement = (wchar_t)0xFFFD;
+
+        void Start(u32 bits, u32 continuations, u32 smallest) noexcept
         {
-            WriteValueBegin();
-            writer->Write(value ? EJSON_TEXT("true") : EJSON_TEXT("false"));
-            WriteValueEnd();
+            codePoint = bits;
+            remaining = continuations;
+            minimum = smallest;
         }
 
-        void WriteNumber(number value) noexcept
+        // overlong forms, surrogates and values past U+10FFFF are invalid
+        wchar_t* Put(wchar_t* out, u32 value) const noexcept
         {
-            WriteValueBegin();
-            StringClear(tmpString); // not needed ?
-            ::ejson::WriteNumber(value, tmpString);
-            writer->Write(tmpString);
-            WriteValueEnd();
+            if (value < minimum || (value >= 0xD800 && value < 0xE000) || value > 0x10FFFF)
+            {
+                *out++ = Replacement;
+            }
+            else if (sizeof(wchar_t) == 2 && value >= 0x10000)
+            {
+                value -= 0x10000;
+                *out++ = (wchar_t)(0xD800 + (value >> 10));
+                *out++ = (wchar_t)(0xDC00 + (value & 0x3FF));
+            }
+            else
+            {
+                *out++ = (wchar_t)value;
+            }
+            return out;
         }
 
-        template <typename STR_TYPE>
-        void WriteString(const STR_TYPE& value) noexcept
+        u32 codePoint = 0;
+        u32 remaining = 0;
+        u32 minimum = 0;
+    };
+
+    // Read a file without iostream: regular files are memory mapped read only, other files (pipes, devices)
+    // are read in chunks. Input is taken byte per byte, in wchar_t mode UTF-8 is decoded chunk by chunk.
+    class FileReader
+    {
+#if defined(_WIN32)
+        // windows.h values, under other names since windows.h defines them as macros
+        static constexpr unsigned long GenericRead = 0x80000000;
+        static constexpr unsigned long FileShareRead = 0x00000001;
+        static constexpr unsigned long OpenExisting = 3;
+        static constexpr unsigned long FileFlagSequentialScan = 0x08000000;
+        static constexpr unsigned long FileTypeDisk = 0x0001;
+        static constexpr unsigned long PageReadOnly = 0x02;
+        static constexpr unsigned long FileMapRead = 0x0004;
+        static inline void* const InvalidHandle = (void*)(intptr_t)-1;
+#endif
+    public:
+
+        FileReader(const std::filesystem::path& path) noexcept
         {
-            WriteValueBegin();
-            writer->Write(EJSON_TEXT("\""));
-            writer->Write(value);
-            writer->Write(EJSON_TEXT("\""));
-            WriteValueEnd();
+#if defined(_WIN32)
+            file = CreateFileW(path.c_str(), GenericRead, FileShareRead, nullptr, OpenExisting, FileFlagSequentialScan, nullptr);
+            if (file == InvalidHandle)
+                return;
+    #if EJSON_FILE_MAPPING
+            long long fileSize = 0;
+            if (GetFileType(file) == FileTypeDisk && GetFileSizeEx(file, (_LARGE_INTEGER*)&fileSize) && fileSize > 0)
+            {
+                mapping = CreateFileMappingW(file, nullptr, PageReadOnly, 0, 0, nullptr);
+                if (mapping != nullptr)
+                {
+                    data = (const char*)MapViewOfFile(mapping, FileMapRead, 0, 0, 0);
+                    if (data != nullptr)
+                    {
+                        size = (size_t)fileSize;
+                    }
+                    else
+                    {
+                        CloseHandle(mapping);
+                        mapping = nullptr;
+                    }
+                }
+            }
+    #endif
+#else
+            file = ::open(path.c_str(), O_RDONLY);
+            if (file < 0)
+                return;
+    #if EJSON_FILE_MAPPING
+            struct stat status;
+            if (::fstat(file, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+            {
+                void* address = ::mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+                if (address != MAP_FAILED)
+                {
+                    ::madvise(address, (size_t)status.st_size, MADV_SEQUENTIAL);
+                    data = (const char*)address;
+                    size = (size_t)status.st_size;
+                }
+            }
+    #endif
+#endif
         }
 
-        void WriteObjectBegin() noexcept
+        FileReader(const FileReader&) = delete;
+        FileReader& operator=(const FileReader&) = delete;
+
+        ~FileReader() noexcept
         {
-            WriteValueBegin();
-            WriteContainerBegin();
-            PushState(StateType::Object);
-            writer->Write(EJSON_TEXT("{"));
+#if defined(_WIN32)
+            if (data != nullptr)
+                UnmapViewOfFile(data);
+            if (mapping != nullptr)
+                CloseHandle(mapping);
+            if (file != InvalidHandle)
+                CloseHandle(file);
+#else
+            if (data != nullptr)
+                ::munmap((void*)data, size);
+            if (file >= 0)
+                ::close(file);
+#endif
         }
 
-        void WriteObjectEnd() noexcept
+        bool IsOpen() const noexcept
         {
-            EJSON_ASSERT(GetState().Type == StateType::Object, "internal error");
-            WriteContainerEnd();
-            writer->Write(EJSON_TEXT("}"));
-            WriteValueEnd();
+#if defined(_WIN32)
+            return file != InvalidHandle;
+#else
+            return file >= 0;
+#endif
         }
 
-        template <typename STR_TYPE>
-        void WriteProperty(const STR_TYPE& name) noexcept
+        bool IsMapped() const noexcept
         {
-            State& root = GetState();
-            EJSON_ASSERT(root.Type == StateType::Object, "internal error");
-            WriteValuePrefix();
-            PushState(StateType::Property);
-            writer->Write(EJSON_TEXT("\""));
-            writer->Write(name);
-            writer->Write(EJSON_TEXT("\""));
-            writer->Write(EJSON_TEXT(":"));
-            if constexpr (PRETTIFY)
-                writer->Write(EJSON_TEXT(" "));
+            return data != nullptr;
         }
 
-        void WriteArrayBegin() noexcept
+        // the whole mapped file, bytes as they are on disk
+        c_string_view MappedData() const noexcept
         {
-            WriteValueBegin();
-            WriteContainerBegin();
-            PushState(StateType::Array);
-            writer->Write(EJSON_TEXT("["));
+            return c_string_view(data, size);
         }
 
-        void WriteArrayEnd() noexcept
+        bool Fill(const string_char*& begin, const string_char*& end) noexcept
         {
-            EJSON_ASSERT(GetState().Type == StateType::Array, "internal error");
-            WriteContainerEnd();
-            writer->Write(EJSON_TEXT("]"));
-            WriteValueEnd();
+            while (true)
+            {
+                const char* bytes = nullptr;
+                size_t count = 0;
+
+                if (data != nullptr)
+                {
+                    // handed out in chunks too, the parser counts lines of a span before moving to the next one
+                    bytes = data + position;
+                    count = std::min(size - position, BufferSize);
+                    position += count;
+                }
+                else if (IsOpen())
+                {
+                    if (!readBuffer)
+                        readBuffer = std::make_unique<char[]>(BufferSize);
+                    bytes = readBuffer.get();
+                    count = ReadChunk(readBuffer.get(), BufferSize);
+                }
+
+#if EJSON_WCHAR
+                if (!wideBuffer)
+                    wideBuffer = std::make_unique<string_char[]>(BufferSize + 1);
+                // a chunk ending inside a sequence may give no character yet
+                if (count != 0)
+                    count = decoder.Decode(bytes, count, wideBuffer.get());
+                else if (decoder.Finish(wideBuffer.get()) != 0)
+                    count = 1;
+                else
+                    return false;
+                begin = wideBuffer.get();
+#else
+                if (count == 0)
+                    return false;
+                begin = bytes;
+#endif
+                end = begin + count;
+                if (count != 0)
+                    return true;
+            }
         }
 
     private:
 
-        enum class StateType : std::uint8_t
-        {
-            Root,
-            Value,
-            Object,
-            Property,
-            Array,
-        };
+        static constexpr size_t BufferSize = 64 * 1024;
 
-        struct State
+        size_t ReadChunk(char* buffer, size_t bufferSize) noexcept
         {
-            std::int16_t Indentation = 0;
-            std::int16_t Count = 0;
-            StateType Type = StateType::Root;
-        };
+#if defined(_WIN32)
+            unsigned long bytesRead = 0;
+            if (!ReadFile(file, buffer, (unsigned long)bufferSize, &bytesRead, nullptr))
+                return 0;
+            return (size_t)bytesRead;
+#else
+            while (true)
+            {
+                ssize_t bytesRead = ::read(file, buffer, bufferSize);
+                if (bytesRead >= 0)
+                    return (size_t)bytesRead;
+                if (errno != EINTR)
+                    return 0;
+            }
+#endif
+        }
 
-        void WriteIndentation() noexcept
+#if defined(_WIN32)
+        void* file = InvalidHandle;
+        void* mapping = nullptr;
+#else
+        int file = -1;
+#endif
+        const char* data = nullptr;
+        size_t size = 0;
+        size_t position = 0;
+        std::unique_ptr<char[]> readBuffer;
+#if EJSON_WCHAR
+        std::unique_ptr<string_char[]> wideBuffer;
+        Utf8Decoder decoder;
+#endif
+    };
+
+    // Collects output in a buffer handed to sink(const string_view&) in bulk: when flushSize characters are
+    // pending, on Flush() and on destruction. Text larger than flushSize goes to the sink directly.
+    // The sink returns false on failure, later output is dropped and Flush() returns false.
+    template<typename SINK>
+    class BufferedWriter
+    {
+    public:
+
+        static constexpr size_t DefaultFlushSize = 64 * 1024;
+
+        BufferedWriter(SINK sink, size_t flushSize = DefaultFlushSize) noexcept
+            : sink(EJSON_MOVE(sink)), flushSize(flushSize == 0 ? 1 : flushSize)
+        {}
+
+        BufferedWriter(const BufferedWriter&) = delete;
+        BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+        ~BufferedWriter() noexcept
         {
-            static_assert(PRETTIFY);
-            for (int i = 0; i < indentation; ++i)
-                writer->Write(tab);
+            Flush();
         }
 
-        void WriteValuePrefix() noexcept
+        bool Write(string_char car) noexcept
         {
-            if (GetState().Count != 0)
-                writer->Write(EJSON_TEXT(","));
-            if constexpr (PRETTIFY)
-            {
-                if (GetState().Type != StateType::Root)
-                {
-                    writer->Write(EJSON_TEXT("\n"));
-                    WriteIndentation();
-                }
-            }
+            StringAdd(buffer, car);
+            if (StringSize(buffer) >= flushSize)
+                FlushBuffer();
+            return good;
         }
 
-        void WriteValueBegin() noexcept
+#if EJSON_WCHAR
+        size_t Write(const c_string_view& str) noexcept
         {
-            State& state = GetState();
-            EJSON_ASSERT(state.Type == StateType::Property || state.Type == StateType::Array || state.Type == StateType::Root, "internal error");
-            EJSON_ASSERT(state.Type != StateType::Root || state.Count == 0, "Json root may contain only one value");
-            State& root = state.Type == StateType::Property ? GetState(1) : GetState();
-            if (state.Type != StateType::Property)
-            {
-                WriteValuePrefix();
-            }
-            ++root.Count;
-            PushState(StateType::Value);
+            w_string wstr;
+            StringConvert(str, wstr);
+            return Write(w_string_view(wstr));
+        }
+        size_t Write(const w_string_view& str) noexcept
+        {
+            return WriteText(str);
+        }
+#else
+        size_t Write(const c_string_view& str) noexcept
+        {
+            return WriteText(str);
         }
 
-        void WriteValueEnd() noexcept
+        size_t Write(const w_string_view& str) noexcept
         {
-            EJSON_ASSERT(GetState().Type == StateType::Value, "internal error");
-            PopState();
-            if (GetState().Type == StateType::Property)
-                PopState();
+            c_string cstr;
+            StringConvert(str, cstr);
+            return Write(c_string_view(cstr));
         }
+#endif
 
-        void WriteContainerBegin() noexcept
+        // hand pending output to the sink, false if the sink failed since the writer was created
+        bool Flush() noexcept
         {
-            if constexpr (PRETTIFY)
-                ++indentation;
+            FlushBuffer();
+            return good;
         }
 
-        void WriteContainerEnd() noexcept
+    private:
+
+        size_t WriteText(const string_view& str) noexcept
         {
-            if constexpr (PRETTIFY)
-            {
-                const std::int16_t previousCount = GetState().Count;
-                if (previousCount != 0)
-                    writer->Write(EJSON_TEXT("\n"));
-                PopState();
-                --indentation;
-                if (previousCount != 0)
-                    WriteIndentation();
-            }
-            else
+            if (StringSize(buffer) + StringSize(str) >= flushSize)
             {
-                PopState();
+                FlushBuffer();
+                if (StringSize(str) >= flushSize)
+                {
+                    good = good && sink(str);
+                    return good ? StringSize(str) : 0;
+                }
             }
+            StringAdd(buffer, str.data(), str.data() + StringSize(str));
+            return good ? StringSize(str) : 0;
         }
 
-        void PushState(StateType type) noexcept
+        void FlushBuffer() noexcept
         {
-            VectorEmplace(states, State{ 0,0,type });
+            if (StringSize(buffer) == 0)
+                return;
+            good = good && sink(string_view(buffer));
+            StringClear(buffer);
         }
 
-        void PopState() noexcept
-        {
-            EJSON_ASSERT(VectorSize(states) > 0, "internal error");
-            VectorRemoveLast(states);
-        }
+        SINK sink;
+        size_t flushSize;
+        string buffer;
+        bool good = true;
+    };
 
-        State& GetState(size_t depth = 0) noexcept
+    struct StreamSink
+    {
+        output_stream* stream;
+
+        bool operator()(const string_view& str) noexcept
         {
-            EJSON_ASSERT(VectorSize(states) > 0, "internal error");
-            return states[VectorSize(states) - (1 + depth)];
+            return StreamWrite(*stream, str) == StringSize(str);
         }
+    };
 
-        vector<State> states;
-        STRING_WRITER* writer = nullptr;
-        std::int32_t indentation = 0;
-        const string_char* tab = EJSON_TEXT("    ");
-        string tmpString;
+    // output reaches the stream in blocks, on Flush() and when the writer is destroyed
+    class StreamWriter : public BufferedWriter<StreamSink>
+    {
+    public:
+
+        StreamWriter(output_stream& stream, size_t flushSize = DefaultFlushSize) noexcept
+            : BufferedWriter(StreamSink{ &stream }, flushSize)
+        {}
     };
 
-    class StringReader
+#if EJSON_MAP_ORDERED
+    // Property names of reads: objects get the same SharedKey for the same name, a key is stored once however
+    // many objects use it. Past MaxKeys names (objects used as dictionaries) new names are no longer kept.
+    class KeyTable
     {
     public:
 
-        StringReader(string_view str, bool owner = false) noexcept
+        using Key = SharedKey<string>;
+
+        static constexpr size_t MaxKeys = 4096;
+
+        Key Intern(string_view name) noexcept
         {
-            if (owner)
+            const size_t hash = Key::Hash(name);
+            if (VectorSize(slots) == 0)
+                slots.resize(64);
+
+            const size_t mask = VectorSize(slots) - 1;
+            size_t slot = hash & mask;
+            while (!slots[slot].IsNull())
             {
-                string = str;
-                stringView = string;
+                if (slots[slot].GetHash() == hash && slots[slot].Get() == name)
+                    return slots[slot];
+                slot = (slot + 1) & mask;
             }
-            else
+
+            Key key(string(name), hash);
+            if (count < MaxKeys)
             {
-                stringView = str;
+                slots[slot] = key;
+                ++count;
+                if (count * 2 > VectorSize(slots))
+                    Grow();
             }
+            return key;
         }
 
-        StringReader(const StringReader&) = delete;
-        StringReader& operator=(const StringReader&) = delete;
-        ~StringReader() {}
+    private:
 
-        bool Read(string_char& car) noexcept
+        void Grow() noexcept
         {
-            if (position < StringSize(stringView))
+            // the table keeps its allocator, it is not part of the tree
+            vector<Key> old(VectorSize(slots) * 2, slots.get_allocator());
+            std::swap(old, slots);
+            const size_t mask = VectorSize(slots) - 1;
+            for (Key& key : old)
             {
-                car = stringView[position];
-                ++position;
-                return true;
-            }
-            else
-            {
-                return false;
+                if (key.IsNull())
+                    continue;
+                size_t slot = key.GetHash() & mask;
+                while (!slots[slot].IsNull())
+                    slot = (slot + 1) & mask;
+                slots[slot] = EJSON_MOVE(key);
             }
         }
 
-    private:
+        vector<Key> slots;
+        size_t count = 0;
+    };
+#else
+    // std::map keeps its own copy of each key
+    class KeyTable
+    {
+    public:
 
-        string string;
-        string_view stringView;
-        size_t position = 0;
+        using Key = string;
+
+        Key Intern(string_view name) noexcept
+        {
+            return string(name);
+        }
     };
+#endif
 
-    class StringWriter
+    struct ValueReader
     {
+        ValueReader(Value& json) noexcept
+            : root(json)
+        {}
 
-    public:
+        // keyTable shares property names with other reads (records of a file)
+        ValueReader(Value& json, KeyTable& keyTable) noexcept
+            : root(json), keyTable(&keyTable)
+        {}
 
-        StringWriter() noexcept
+        void ObjectBegin() noexcept
         {
-            string = &stringData;
+            Value value;
+            value.SetObject(map<string, Value>());
+            Value* objectValue = SetValue(EJSON_MOVE(value));
+            VectorEmplace(contexts, EJSON_MOVE(objectValue));
         }
 
-        StringWriter(string& str) noexcept
-            : string(&str)
-        {}
+        void ObjectEnd() noexcept
+        {
+            EJSON_ASSERT(GetContext().IsObject(), "object type expected");
+            VectorRemoveLast(contexts);
+        }
 
-        StringWriter(const StringWriter&) = delete;
-        StringWriter& operator=(const StringWriter&) = delete;
+        void PropertyBegin(const string_view& key) noexcept
+        {
+            propertyKey = (keyTable != nullptr ? *keyTable : ownKeyTable).Intern(key);
+        }
 
-        ~StringWriter() noexcept {}
+        void PropertyEnd() noexcept
+        {
+        }
 
+        void ArrayBegin() noexcept
+        {
+            Value value;
+            value.SetArray(vector<Value>());
+            Value* arrayValue = SetValue(EJSON_MOVE(value));
+            VectorEmplace(contexts, EJSON_MOVE(arrayValue));
+        }
 
-        bool Write(string_char car) noexcept
+        void ArrayEnd() noexcept
         {
-            StringAdd(*string, car);
-            return true;
+            EJSON_ASSERT(GetContext().IsArray(), "array type expected");
+            VectorRemoveLast(contexts);
         }
 
-#if EJSON_WCHAR
-        size_t Write(const c_string_view& str) noexcept
+        void ValueBool(bool b) noexcept
         {
-            w_string wstr;
-            StringConvert(str, wstr);
-            StringAdd(*string, wstr);
-            return StringSize(wstr);
+            Value value;
+            value.SetBool(b);
+            SetValue(EJSON_MOVE(value));
         }
-        size_t Write(const w_string_view& str) noexcept
+
+        void ValueNull() noexcept
         {
-            StringAdd(*string, ::ejson::string(str));
-            return StringSize(str);
+            Value value;
+            value.SetNull();
+            SetValue(EJSON_MOVE(value));
+        }
+
+        void ValueString(const string_view& str) noexcept
+        {
+            Value value;
+            value.SetString(str);
+            SetValue(EJSON_MOVE(value));
+        }
+
+#if EJSON_LAZY_NUMBERS
+        // kept as text, the tokenizer does not convert it
+        void ValueNumber(const string_view& str) noexcept
+        {
+            Value value;
+            value.SetNumberText(str);
+            SetValue(EJSON_MOVE(value));
         }
 #else
-        size_t Write(const c_string_view& str) noexcept
+        void ValueNumber(const string_view& str) noexcept
         {
-            StringAdd(*string, ::ejson::string(str));
-            return StringSize(str);
+            NumberToken token;
+            ParseNumber(str, token);
+            ValueNumber(token);
         }
 
-        size_t Write(const w_string_view& str) noexcept
+        // already converted by the tokenizer, integers are kept exact
+        void ValueNumber(const NumberToken& token) noexcept
         {
-            c_string cstr;
-            StringConvert(str, cstr);
-            StringAdd(*string, cstr);
-            return StringSize(cstr);
+            Value value;
+            value.SetNumber(token);
+            SetValue(EJSON_MOVE(value));
         }
 #endif
 
-        string ToString() const noexcept { return *string; }
-
     private:
 
-        string stringData;
-        string* string = nullptr;
+        Value& root;
+        vector<Value*> contexts;
+        KeyTable ownKeyTable;
+        KeyTable* keyTable = nullptr;
+        KeyTable::Key propertyKey;
+
+        Value& GetContext() noexcept
+        {
+            EJSON_ASSERT(VectorSize(contexts) > 0, "internal error");
+            return *contexts[VectorSize(contexts) - 1];
+        }
+
+        Value* SetValue(Value&& value) noexcept
+        {
+            if (VectorSize(contexts) == 0)
+            {
+                root = value;
+                return &root;
+            }
+            else
+            {
+                Value& context = GetContext();
+
+                if (context.IsArray())
+                {
+                    vector<Value>& array = context.AsArray();
+                    VectorEmplace(array, EJSON_FORWARD<Value>(value));
+                    Value* addedValue = &array[VectorSize(array) - 1];
+                    return addedValue;
+                }
+                else if (context.IsObject())
+                {
+                    // a repeated key replaces the previous value (the last one wins)
+                    map<string, Value>& object = context.AsObject();
+                    Value* propertyValue = MapTryEmplace(object, EJSON_MOVE(propertyKey), Value());
+                    propertyValue->Set(EJSON_FORWARD<Value>(value));
+                    return propertyValue;
+                }
+                else
+                {
+                    EJSON_ERROR("internal error");
+                    return nullptr;
+                }
+            }
+        }
     };
 
-    class StreamReader
+    // Paths compiled into a matcher, shared by any number of reads (also concurrently, it is not modified by them).
+    //
+    // JSON Pointer:  "" (the whole document), "/store/book/0/title", "~1" and "~0" escape '/' and '~'
+    // JSONPath:      "$", "$.store.book[0].title", "$['store']", "$.store.*.title", "$.book[*]"
+    //
+    // Array indices match like names ("/book/0" also matches a property named "0"), '*' matches any name or index.
+    class PathFilter
     {
+
     public:
 
-        StreamReader(input_stream& stream) noexcept
-            : stream(stream)
-        {}
+        static constexpr u32 Dead = 0;
 
-        StreamReader(const StreamReader&) = delete;
-        StreamReader& operator=(const StreamReader&) = delete;
-        ~StreamReader() noexcept {}
+        PathFilter() noexcept
+        {
+            Compile();
+        }
 
-        bool Read(string_char& car) noexcept
+        // invalid paths are ignored, Add tells which ones are
+        PathFilter(std::initializer_list<string_view> paths) noexcept
+            : PathFilter()
         {
-            if (stream.get(car))
-                return true;
-            else
-                return false;
+            for (const string_view& path : paths)
+                Add(path);
         }
 
-    private:
+        // add a path and recompile, false if the path is invalid (the filter is then unchanged)
+        bool Add(string_view path) noexcept
+        {
+            vector<Step> steps;
+            if (!ParsePath(path, steps))
+                return false;
 
-        input_stream& stream;
+            if (nodes.empty())
+                VectorEmplace(nodes, Node());
+            u32 node = 0;
+            for (Step& step : steps)
+            {
+                u32 next = Dead;
+                if (step.Wildcard)
+                {
+                    next = nodes[node].Wildcard;
+                }
+                else
+                {
+                    for (const auto& [name, child] : nodes[node].Names)
+                    {
+                        if (name == step.Name)
+                            next = child;
+                    }
+                }
+                if (next == Dead)
+                {
+                    next = (u32)VectorSize(nodes);
+                    VectorEmplace(nodes, Node());
+                    if (step.Wildcard)
+                        nodes[node].Wildcard = next;
+                    else
+                        nodes[node].Names.emplace_back(EJSON_MOVE(step.Name), next);
+                }
+                node = next;
+            }
+            nodes[node].Accept = true;
 
-    };
+            Compile();
+            return true;
+        }
 
-    class StreamWriter
-    {
+        u32 Start() const noexcept { return 1; }
+        bool IsDead(u32 state) const noexcept { return state == Dead; }
+        // the whole value at this state is selected
+        bool Accepts(u32 state) const noexcept { return states[state].Accept; }
 
-    public:
+        u32 Next(u32 state, string_view name) const noexcept
+        {
+            const vector<std::pair<string, u32>>& names = states[state].Names;
+            auto it = std::lower_bound(names.begin(), names.end(), name, [](const std::pair<string, u32>& entry, string_view name) { return string_view(entry.first) < name; });
+            if (it != names.end() && it->first == name)
+                return it->second;
+            return states[state].Other;
+        }
 
-        StreamWriter(output_stream& stream) noexcept
-            : stream(stream)
-        {}
+        u32 NextIndex(u32 state, size_t index) const noexcept
+        {
+            if (states[state].Names.empty())
+                return states[state].Other;
+            string_char digits[24];
+            string_char* begin = digits + 24;
+            do
+            {
+                *--begin = (string_char)(EJSON_TEXT('0') + index % 10);
+                index /= 10;
+            } while (index != 0);
+            return Next(state, string_view(begin, digits + 24 - begin));
+        }
+
+    private:
+
+        struct Step
+        {
+            string Name;
+            bool Wildcard = false;
+        };
 
-        StreamWriter(const StringWriter&) = delete;
-        StreamWriter& operator=(const StreamWriter&) = delete;
+        // paths as a tree, node 0 is the root
+        struct Node
+        {
+            vector<std::pair<string, u32>> Names;
+            u32 Wildcard = Dead;
+            bool Accept = false;
+        };
 
-        ~StreamWriter() noexcept {}
+        // the tree as a deterministic automaton, a state stands for the set of nodes reached by a path,
+        // Names is sorted, any other name goes to Other
+        struct State
+        {
+            vector<std::pair<string, u32>> Names;
+            u32 Other = Dead;
+            bool Accept = false;
+        };
 
+        vector<Node> nodes;
+        vector<State> states;
 
-        bool Write(string_char car) noexcept
+        static bool ParsePath(string_view path, vector<Step>& steps) noexcept
         {
-            return StreamWrite(stream, car);
+            if (path.empty())
+                return true;
+
+            if (path[0] == EJSON_TEXT('/'))
+            {
+                // JSON Pointer
+                size_t pos = 1;
+                while (true)
+                {
+                    Step step;
+                    for (; pos < path.size() && path[pos] != EJSON_TEXT('/'); ++pos)
+                    {
+                        string_char c = path[pos];
+                        if (c == EJSON_TEXT('~'))
+                        {
+                            if (++pos == path.size() || (path[pos] != EJSON_TEXT('0') && path[pos] != EJSON_TEXT('1')))
+                                return false;
+                            c = path[pos] == EJSON_TEXT('0') ? EJSON_TEXT('~') : EJSON_TEXT('/');
+                        }
+                        StringAdd(step.Name, c);
+                    }
+                    VectorEmplace(steps, EJSON_MOVE(step));
+                    if (pos == path.size())
+                        return true;
+                    ++pos;
+                }
+            }
+
+            if (path[0] != EJSON_TEXT('$'))
+                return false;
+
+            // JSONPath
+            size_t pos = 1;
+            while (pos < path.size())
+            {
+                Step step;
+                if (path[pos] == EJSON_TEXT('.'))
+                {
+                    const size_t begin = ++pos;
+                    while (pos < path.size() && path[pos] != EJSON_TEXT('.') && path[pos] != EJSON_TEXT('['))
+                        ++pos;
+                    if (pos == begin)
+                        return false;
+                    step.Name = path.substr(begin, pos - begin);
+                    step.Wildcard = step.Name == EJSON_TEXT("*");
+                }
+                else if (path[pos] == EJSON_TEXT('['))
+                {
+                    if (++pos == path.size())
+                        return false;
+                    const string_char quote = path[pos];
+                    if (quote == EJSON_TEXT('\'') || quote == EJSON_TEXT('"'))
+                    {
+                        for (++pos; pos < path.size() && path[pos] != quote; ++pos)
+                        {
+                            if (path[pos] == EJSON_TEXT('\\') && ++pos == path.size())
+                                return false;
+                            StringAdd(step.Name, path[pos]);
+                        }
+                        if (pos == path.size())
+                            return false;
+                        ++pos;
+                    }
+                    else if (quote == EJSON_TEXT('*'))
+                    {
+                        step.Wildcard = true;
+                        ++pos;
+                    }
+                    else
+                    {
+                        const size_t begin = pos;
+                        while (pos < path.size() && path[pos] >= EJSON_TEXT('0') && path[pos] <= EJSON_TEXT('9'))
+                            ++pos;
+                        if (pos == begin)
+                            return false;
+                        step.Name = path.substr(begin, pos - begin);
+                    }
+                    if (pos == path.size() || path[pos] != EJSON_TEXT(']'))
+                        return false;
+                    ++pos;
+                }
+                else
+                {
+                    return false;
+                }
+                VectorEmplace(steps, EJSON_MOVE(step));
+            }
+            return true;
         }
 
-#if EJSON_WCHAR
-        size_t Write(const c_string_view& str) noexcept
-        {
-            w_string wstr;
-            StringConvert(str, wstr);
-            return StreamWrite(stream, wstr);
-        }
-        size_t Write(const w_string_view& str) noexcept
-        {
-            return StreamWrite(stream, str);
-        }
-#else
-        size_t Write(const c_string_view& str) noexcept
+        // subset construction, state 0 is the empty set (Dead), state 1 the root
+        void Compile() noexcept
         {
-            return StreamWrite(stream, str);
-        }
+            states.clear();
+            VectorEmplace(states, State());
+            if (nodes.empty())
+            {
+                VectorEmplace(states, State());
+                return;
+            }
 
-        size_t Write(const w_string_view& str) noexcept
-        {
-            c_string cstr;
-            StringConvert(str, cstr);
-            return StreamWrite(stream, cstr);
-        }
-#endif
+            std::map<vector<u32>, u32> ids;
+            vector<vector<u32>> sets;
+            ids[{}] = Dead;
+            VectorEmplace(sets, vector<u32>());
 
-    private:
+            auto stateOf = [&](vector<u32>&& set) -> u32
+            {
+                std::sort(set.begin(), set.end());
+                set.erase(std::unique(set.begin(), set.end()), set.end());
+                auto [it, added] = ids.try_emplace(set, (u32)VectorSize(sets));
+                if (added)
+                {
+                    VectorEmplace(sets, EJSON_MOVE(set));
+                    VectorEmplace(states, State());
+                }
+                return it->second;
+            };
 
-        output_stream& stream;
+            stateOf({ 0 });
+            for (u32 id = 1; id < (u32)VectorSize(sets); ++id)
+            {
+                // copies: sets and states grow in the loop
+                const vector<u32> set = sets[id];
+                bool accept = false;
+                vector<u32> other;
+                vector<string> names;
+                for (u32 node : set)
+                {
+                    accept |= nodes[node].Accept;
+                    if (nodes[node].Wildcard != Dead)
+                        VectorEmplace(other, (u32)nodes[node].Wildcard);
+                    for (const auto& entry : nodes[node].Names)
+                        VectorEmplace(names, string(entry.first));
+                }
+                states[id].Accept = accept;
+                if (accept)
+                    continue;
+
+                std::sort(names.begin(), names.end());
+                names.erase(std::unique(names.begin(), names.end()), names.end());
+                vector<std::pair<string, u32>> transitions;
+                for (string& name : names)
+                {
+                    vector<u32> next = other;
+                    for (u32 node : set)
+                    {
+                        for (const auto& [childName, child] : nodes[node].Names)
+                        {
+                            if (childName == name)
+                                VectorEmplace(next, (u32)child);
+                        }
+                    }
+                    const u32 nextState = stateOf(EJSON_MOVE(next));
+                    transitions.emplace_back(EJSON_MOVE(name), nextState);
+                }
+                const u32 otherState = stateOf(EJSON_MOVE(other));
+                states[id].Names = EJSON_MOVE(transitions);
+                states[id].Other = otherState;
+            }
+        }
     };
 
-    struct ValueReader
+    // Listener building a Value with the parts of the document selected by a PathFilter, the rest is skipped
+    // without being tokenized. Containers leading to a selected value are kept (arrays keep their indices,
+    // elements in between are null), a root container is kept even when nothing inside is selected.
+    class PathReader
     {
-        ValueReader(Value& json) noexcept
-            : root(json)
+
+    public:
+
+        PathReader(const PathFilter& filter, Value& json) noexcept
+            : filter(filter), root(json)
         {}
 
-        void ObjectBegin() noexcept
+        Listen ObjectBegin() noexcept
         {
-            Value value;
-            value.SetObject(map<string, Value>());
-            Value* objectValue = SetValue(EJSON_MOVE(value));
-            VectorEmplace(contexts, EJSON_MOVE(objectValue));
+            return ContainerBegin(false);
         }
 
         void ObjectEnd() noexcept
         {
-            EJSON_ASSERT(GetContext().IsObject(), "object type expected");
-            VectorRemoveLast(contexts);
+            ContainerEnd(false);
         }
 
-        void PropertyBegin(const string_view& key) noexcept
+        Listen PropertyBegin(const string_view& key) noexcept
         {
-            propertyName = key;
+            if (depth != 0)
+            {
+                valueReader->PropertyBegin(key);
+                return Listen::Continue;
+            }
+
+            Frame& frame = frames.back();
+            nextState = filter.Next(frame.State, key);
+            if (filter.IsDead(nextState))
+                return Listen::Skip;
+            frame.Key = key;
+            return Listen::Continue;
         }
 
         void PropertyEnd() noexcept
         {
+            if (depth != 0)
+                valueReader->PropertyEnd();
         }
 
-        void ArrayBegin() noexcept
+        Listen ArrayBegin() noexcept
         {
-            Value value;
-            value.SetArray(vector<Value>());
-            Value* arrayValue = SetValue(EJSON_MOVE(value));
-            VectorEmplace(contexts, EJSON_MOVE(arrayValue));
+            return ContainerBegin(true);
         }
 
         void ArrayEnd() noexcept
         {
-            EJSON_ASSERT(GetContext().IsArray(), "array type expected");
-            VectorRemoveLast(contexts);
+            ContainerEnd(true);
         }
 
         void ValueBool(bool b) noexcept
         {
-            Value value;
-            value.SetBool(b);
-            SetValue(EJSON_MOVE(value));
+            if (ScalarBegin())
+                valueReader->ValueBool(b);
         }
 
         void ValueNull() noexcept
         {
-            Value value;
-            value.SetNull();
-            SetValue(EJSON_MOVE(value));
+            if (ScalarBegin())
+                valueReader->ValueNull();
         }
 
         void ValueString(const string_view& str) noexcept
         {
-            Value value;
-            value.SetString(string(str));
-            SetValue(EJSON_MOVE(value));
+            if (ScalarBegin())
+                valueReader->ValueString(str);
         }
 
         void ValueNumber(const string_view& str) noexcept
         {
-            number number = 0;
-            ParseNumber(str, number);
-            Value value;
-            value.SetNumber(number);
-            SetValue(EJSON_MOVE(value));
+            if (ScalarBegin())
+                valueReader->ValueNumber(str);
+        }
+
+#if !EJSON_LAZY_NUMBERS
+        void ValueNumber(const NumberToken& token) noexcept
+        {
+            if (ScalarBegin())
+                valueReader->ValueNumber(token);
         }
+#endif
 
     private:
 
+        // a container on the way to selected values, Json is set once something inside is selected
+        struct Frame
+        {
+            u32 State = PathFilter::Dead;
+            bool Array = false;
+            // elements seen so far (array), name of the current property (object)
+            size_t Count = 0;
+            string Key;
+            Value* Json = nullptr;
+        };
+
+        const PathFilter& filter;
         Value& root;
-        vector<Value*> contexts;
-        string propertyName;
+        vector<Frame> frames;
+        u32 nextState = PathFilter::Dead;
+        // selected value being read by valueReader, depth counts its open containers
+        std::optional<ValueReader> valueReader;
+        u32 depth = 0;
+
+        // state of the value starting now
+        u32 ValueState() noexcept
+        {
+            if (frames.empty())
+                return filter.Start();
+            Frame& frame = frames.back();
+            if (frame.Array)
+                return filter.NextIndex(frame.State, frame.Count++);
+            return nextState;
+        }
 
-        Value& GetContext() noexcept
+        Listen ContainerBegin(bool array) noexcept
         {
-            EJSON_ASSERT(VectorSize(contexts) > 0, "internal error");
-            return *contexts[VectorSize(contexts) - 1];
+            if (depth == 0)
+            {
+                const u32 state = ValueState();
+                if (!filter.Accepts(state))
+                {
+                    Frame frame;
+                    frame.State = state;
+                    frame.Array = array;
+                    if (frames.empty())
+                    {
+                        if (array)
+                            root.SetArray({});
+                        else
+                            root.SetObject({});
+                        frame.Json = &root;
+                    }
+                    if (filter.IsDead(state))
+                        return Listen::Skip;
+                    VectorEmplace(frames, EJSON_MOVE(frame));
+                    return Listen::Continue;
+                }
+                valueReader.emplace(Child());
+            }
+
+            ++depth;
+            if (array)
+                valueReader->ArrayBegin();
+            else
+                valueReader->ObjectBegin();
+            return Listen::Continue;
         }
 
-        Value* SetValue(Value&& value) noexcept
+        void ContainerEnd(bool array) noexcept
         {
-            if (VectorSize(contexts) == 0)
+            if (depth == 0)
             {
-                root = value;
-                return &root;
+                VectorRemoveLast(frames);
+                return;
             }
+
+            --depth;
+            if (array)
+                valueReader->ArrayEnd();
             else
+                valueReader->ObjectEnd();
+        }
+
+        // true if the scalar is selected, valueReader then reads it
+        bool ScalarBegin() noexcept
+        {
+            if (depth != 0)
+                return true;
+
+            const u32 state = ValueState();
+            if (filter.Accepts(state))
             {
-                Value& context = GetContext();
+                valueReader.emplace(Child());
+                return true;
+            }
+            if (frames.empty())
+                root.SetNull();
+            return false;
+        }
 
-                if (context.IsArray())
-                {
-                    vector<Value>& array = context.AsArray();
-                    VectorEmplace(array, EJSON_FORWARD<Value>(value));
-                    Value* addedValue = &array[VectorSize(array) - 1];
-                    return addedValue;
-                }
-                else if (context.IsObject())
-                {
-                    map<string, Value>& object = context.AsObject();
-                    Value* addOrExistingValue = MapTryEmplace(object, string(propertyName), EJSON_FORWARD<Value>(value));
-                    return addOrExistingValue;
-                }
-                else
-                {
-                    EJSON_ERROR("internal error");
-                    return nullptr;
-                }
+        // the value starting in the innermost frame, containers leading to it are added
+        Value& Child() noexcept
+        {
+            if (frames.empty())
+                return root;
+            return ChildOf(frames.size() - 1);
+        }
+
+        Value& ChildOf(size_t index) noexcept
+        {
+            Frame& frame = frames[index];
+            if (frame.Json == nullptr)
+                frame.Json = &ChildOf(index - 1);
+
+            if (!frame.Array)
+                return (*frame.Json)[frame.Key];
+
+            if (!frame.Json->IsArray())
+                frame.Json->SetArray({});
+            vector<Value>& array = frame.Json->AsArray();
+            while (VectorSize(array) < frame.Count)
+            {
+                Value value;
+                value.SetNull();
+                VectorEmplace(array, EJSON_MOVE(value));
             }
+            return array[frame.Count - 1];
         }
     };
 
@@ -1871,12 +6840,26 @@ namespace ejson
                 }
                 case Value::Type::Number:
                 {
-                    jsonWriter.WriteNumber(value.AsNumber());
+                    switch (value.GetNumberType())
+                    {
+                        case NumberType::Int64:
+                            jsonWriter.WriteInt64(value.AsInt64());
+                            break;
+                        case NumberType::UInt64:
+                            jsonWriter.WriteUInt64(value.AsUInt64());
+                            break;
+                        case NumberType::Text:
+                            jsonWriter.WriteNumberText(value.GetNumberText());
+                            break;
+                        default:
+                            jsonWriter.WriteNumber(value.GetNumber());
+                            break;
+                    }
                     break;
                 }
                 case Value::Type::String:
                 {
-                    jsonWriter.WriteString(value.AsString());
+                    jsonWriter.WriteString(value.AsStringView());
                     break;
                 }
                 case Value::Type::Array:
@@ -1909,14 +6892,356 @@ namespace ejson
 
     };
 
+    // Json Lines
+    //
+    // NDJSON / JSON Lines: one json document per line. The input is cut in batches of about BatchSize
+    // characters ending on a line, workers parse batches concurrently. A line may end with "\r\n", blank lines
+    // are skipped. Records are numbered by their line in the input (first line is 1), ParserError::Line of a
+    // record error is that line.
+
+    struct LinesOptions
+    {
+        // worker threads, 0 uses all hardware threads, 1 parses on the calling thread
+        u32 Workers = 0;
+        // ReadLines delivers records in input order, otherwise batch by batch as they complete
+        bool Ordered = true;
+        // characters handed to a worker at once
+        size_t BatchSize = 256 * 1024;
+    };
+
+    // Batches shared by workers: batch i starts on the line following character i * batchSize, so a worker
+    // finds its batch alone. Workers count the lines of a batch before parsing it, which numbers the lines
+    // of the next batches. At most window batches are claimed and not yet released.
+    template<typename CHAR>
+    class LinesBatches
+    {
+    public:
+
+        LinesBatches(const CHAR* begin, const CHAR* end, size_t batchSize, size_t window) noexcept
+            : begin(begin), end(end), batchSize(std::max<size_t>(batchSize, 1)), window(std::max<size_t>(window, 1))
+        {
+            count = ((size_t)(end - begin) + this->batchSize - 1) / this->batchSize;
+            lineCounts.resize(count);
+            firstLines.resize(count + 1);
+            firstLines[0] = 1;
+            done.resize(count);
+        }
+
+        LinesBatches(const LinesBatches&) = delete;
+        LinesBatches& operator=(const LinesBatches&) = delete;
+
+        size_t Count() const noexcept { return count; }
+
+        void Bounds(size_t batch, const CHAR*& batchBegin, const CHAR*& batchEnd) const noexcept
+        {
+            batchBegin = Boundary(batch);
+            batchEnd = Boundary(batch + 1);
+        }
+
+        // next batch in input order, false when all are claimed
+        bool Claim(size_t& batch) noexcept
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&] { return claimed == count || claimed - released < window; });
+            if (claimed == count)
+                return false;
+            batch = claimed++;
+            return true;
+        }
+
+        // lineCount is the number of '\n' in batch, returns the line of its first character
+        size_t Number(size_t batch, size_t lineCount) noexcept
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            lineCounts[batch] = lineCount + 1;
+            while (numbered < count && lineCounts[numbered] != 0)
+            {
+                firstLines[numbered + 1] = firstLines[numbered] + lineCounts[numbered] - 1;
+                ++numbered;
+            }
+            condition.notify_all();
+            condition.wait(lock, [&] { return numbered >= batch; });
+            return firstLines[batch];
+        }
+
+        void Done(size_t batch) noexcept
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done[batch] = 1;
+            VectorEmplace(completed, EJSON_MOVE(batch));
+            condition.notify_all();
+        }
+
+        // next batch to deliver: the next one in order, or the oldest completed, false when all are delivered
+        bool Deliver(size_t& batch, bool ordered) noexcept
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (delivered == count)
+                return false;
+            if (ordered)
+            {
+                condition.wait(lock, [&] { return done[delivered] != 0; });
+                batch = delivered;
+            }
+            else
+            {
+                condition.wait(lock, [&] { return completedRead != VectorSize(completed); });
+                batch = completed[completedRead++];
+            }
+            ++delivered;
+            return true;
+        }
+
+        // the batch results are gone, another batch can be claimed
+        void Release() noexcept
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++released;
+            condition.notify_all();
+        }
+
+    private:
+
+        const CHAR* Boundary(size_t batch) const noexcept
+        {
+            if (batch == 0)
+                return begin;
+            if (batch >= count)
+                return end;
+            const CHAR* line = std::find(begin + batch * batchSize - 1, end, '\n');
+            return line == end ? end : line + 1;
+        }
+
+        const CHAR* begin = nullptr;
+        const CHAR* end = nullptr;
+        size_t batchSize = 0;
+        size_t window = 0;
+        size_t count = 0;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t claimed = 0;
+        size_t released = 0;
+        size_t delivered = 0;
+        // line count + 1 of counted batches, firstLines is valid up to numbered
+        vector<size_t> lineCounts;
+        vector<size_t> firstLines;
+        size_t numbered = 0;
+        vector<u8> done;
+        vector<size_t> completed;
+        size_t completedRead = 0;
+    };
+
+    // Cuts a batch in records for one worker, UTF-8 of a mapped file is decoded in wchar_t mode
+    template<typename CHAR>
+    class LinesWorker
+    {
+    public:
+
+        // record(size_t line, string_view json) for each non blank line of batch
+        template<typename RECORD>
+        void ForEachRecord(LinesBatches<CHAR>& batches, size_t batch, RECORD&& record) noexcept
+        {
+            const CHAR* batchBegin = nullptr;
+            const CHAR* batchEnd = nullptr;
+            batches.Bounds(batch, batchBegin, batchEnd);
+
+            const string_char* begin = nullptr;
+            const string_char* end = nullptr;
+            if constexpr (std::is_same_v<CHAR, string_char>)
+            {
+                begin = batchBegin;
+                end = batchEnd;
+            }
+#if EJSON_WCHAR
+            else
+            {
+                // batches are cut after a '\n', never inside a UTF-8 sequence
+                Utf8Decoder decoder;
+                wide.resize((size_t)(batchEnd - batchBegin) + 1);
+                size_t size = decoder.Decode(batchBegin, (size_t)(batchEnd - batchBegin), wide.data());
+                size += decoder.Finish(wide.data() + size);
+                begin = wide.data();
+                end = begin + size;
+            }
+#endif
+
+            // counting also brings the batch in cache for parsing
+            u32 lineCount = 0;
+            u32 lineChars = 0;
+            CountLines(begin, end, lineCount, lineChars);
+            size_t line = batches.Number(batch, lineCount);
+
+            while (begin != end)
+            {
+                const string_char* lineEnd = std::find(begin, end, EJSON_TEXT('\n'));
+                const string_char* recordEnd = lineEnd;
+                if (recordEnd != begin && recordEnd[-1] == EJSON_TEXT('\r'))
+                    --recordEnd;
+                if (SkipWhitespaces(begin, recordEnd) != recordEnd)
+                    record(line, string_view(begin, (size_t)(recordEnd - begin)));
+                begin = lineEnd == end ? end : lineEnd + 1;
+                ++line;
+            }
+        }
+
+    private:
+
+        string wide;
+    };
+
+    // workers to start, 0 is one per hardware thread
+    inline u32 WorkerCount(u32 workers) noexcept
+    {
+        if (workers != 0)
+            return workers;
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    // Parallel top level array
+    //
+    // A top level array is cut in slices of elements: a quick scan over the structural index follows depth
+    // and strings to find the commas between elements, each slice is parsed by a worker as an array of its
+    // own and the fragments are spliced in order into the root array.
+
+    struct ParallelOptions
+    {
+        // worker threads, 0 uses all hardware threads, 1 parses sequentially
+        u32 Workers = 0;
+        // smaller inputs are parsed sequentially
+        size_t MinSize = 1024 * 1024;
+        // characters of elements handed to a worker at once
+        size_t SliceSize = 256 * 1024;
+    };
+
+    // Hands out a slice of elements wrapped as an array: the first slice holds the root '[' and the last one
+    // the root ']', others get both added.
+    class ArraySliceReader
+    {
+    public:
+
+        ArraySliceReader(string_view slice, bool open, bool close) noexcept
+            : slice(slice), open(open), close(close)
+        {}
+
+        ArraySliceReader(const ArraySliceReader&) = delete;
+        ArraySliceReader& operator=(const ArraySliceReader&) = delete;
+
+        static constexpr bool StableSpans = true;
+
+        bool Fill(const string_char*& begin, const string_char*& end) noexcept
+        {
+            while (part < 3)
+            {
+                string_view span;
+                if (part == 0 && open)
+                    span = EJSON_TEXT("[");
+                else if (part == 1)
+                    span = slice;
+                else if (part == 2 && close)
+                    span = EJSON_TEXT("]");
+                ++part;
+
+                if (StringSize(span) != 0)
+                {
+                    begin = span.data();
+                    end = begin + StringSize(span);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+
+        string_view slice;
+        bool open = false;
+        bool close = false;
+        int part = 0;
+    };
+
+    // Calls comma(size_t offset) for commas between elements of the top level array, at least sliceSize
+    // characters apart. A comma is taken only right after an element so the slice before it ends on a value
+    // and the slice after it starts as JsonReader would after that comma.
+    template<typename COMMA>
+    void ScanArraySlices(string_view json, size_t sliceSize, COMMA&& comma) noexcept
+    {
+        StructuralIndex index(json);
+        size_t nextSlice = sliceSize;
+        int depth = 0;
+        bool inString = false;
+        bool afterValue = false;
+
+        while (index.Next())
+        {
+            const string_char* base = json.data() + index.Base();
+            for (u32 offset : index)
+            {
+                switch (base[offset])
+                {
+                    case EJSON_TEXT('['):
+                    case EJSON_TEXT('{'):
+                        ++depth;
+                        afterValue = false;
+                        break;
+                    case EJSON_TEXT(']'):
+                    case EJSON_TEXT('}'):
+                        --depth;
+                        afterValue = true;
+                        break;
+                    case EJSON_TEXT(','):
+                    {
+                        const size_t position = index.Base() + offset;
+                        if (depth == 1 && afterValue && position >= nextSlice)
+                        {
+                            comma(position);
+                            nextSlice = position + sliceSize;
+                        }
+                        afterValue = false;
+                        break;
+                    }
+                    case EJSON_TEXT(':'):
+                        afterValue = false;
+                        break;
+                    case EJSON_TEXT('"'):
+                        // the closing quote ends a value
+                        inString = !inString;
+                        afterValue = !inString;
+                        break;
+                    default:
+                        afterValue = true;
+                        break;
+                }
+            }
+        }
+    }
+
     // Json
 
     bool Read(string_view json, Value& value) noexcept;
     bool Read(string_view json, Value& value, ParserError& error) noexcept;
     bool Read(input_stream& stream, Value& value) noexcept;
     bool Read(input_stream& stream, Value& value, ParserError& error) noexcept;
+    template<typename PATH> requires std::is_same_v<PATH, std::filesystem::path>
+    bool Read(const PATH& path, Value& value) noexcept;
+    template<typename PATH> requires std::is_same_v<PATH, std::filesystem::path>
+    bool Read(const PATH& path, Value& value, ParserError& error) noexcept;
+    bool Read(string_view json, const PathFilter& filter, Value& value) noexcept;
+    bool Read(string_view json, const PathFilter& filter, Value& value, ParserError& error) noexcept;
+    template<typename PATH> requires std::is_same_v<PATH, std::filesystem::path>
+    bool Read(const PATH& path, const PathFilter& filter, Value& value) noexcept;
+    template<typename PATH> requires std::is_same_v<PATH, std::filesystem::path>
+    bool Read(const PATH& path, const PathFilter& filter, Value& value, ParserError& error) noexcept;
     void Write(const Value& value, string& str, bool prettify = false) noexcept;
     void Write(const Value& value, output_stream& stream, bool prettify = false) noexcept;
+    template<typename CALLBACK>
+    void ReadLines(string_view json, CALLBACK&& callback, const LinesOptions& options = LinesOptions()) noexcept;
+    template<typename PATH, typename CALLBACK> requires std::is_same_v<PATH, std::filesystem::path>
+    bool ReadLines(const PATH& path, CALLBACK&& callback, const LinesOptions& options = LinesOptions()) noexcept;
+    template<typename LISTENER, typename CALLBACK>
+    void ParseLines(string_view json, vector<LISTENER>& listeners, CALLBACK&& callback, const LinesOptions& options = LinesOptions()) noexcept;
+    bool ReadParallel(string_view json, Value& value, const ParallelOptions& options = ParallelOptions()) noexcept;
+    bool ReadParallel(string_view json, Value& value, ParserError& error, const ParallelOptions& options = ParallelOptions()) noexcept;
 
     inline bool Read(string_view json, Value& value) noexcept
     {
@@ -1964,6 +7289,101 @@ namespace ejson
         }
     }
 
+    // PATH is constrained to std::filesystem::path, so string literals still pick the string_view overload
+    template<typename PATH> requires std::is_same_v<PATH, std::filesystem::path>
+    bool Read(const PATH& path, Value& value) noexcept
+    {
+        ParserError error;
+        return Read(path, value, error);
+    }
+
+    template<typename PATH> requires std::is_same_v<PATH, std::filesystem::path>
+    bool Read(const PATH& path, Value& value, ParserError& error) noexcept
+    {
+        FileReader fileReader(path);
+        if (!fileReader.IsOpen())
+        {
+            value.SetInvalid();
+            error = ParserError();
+            error.File = path.template string<string_char, std::char_traits<string_char>, string::allocator_type>();
+            error.Error = EJSON_TEXT("cannot open file");
+            return false;
+        }
+
+        ValueReader valueReader(value);
+        JsonReader jsonReader(valueReader, fileReader);
+        if (jsonReader.Parse())
+        {
+            return true;
+        }
+        else
+        {
+            value.SetInvalid();
+            error = jsonReader.GetError();
+            error.File = path.template string<string_char, std::char_traits<string_char>, string::allocator_type>();
+            return false;
+        }
+    }
+
+    // only the values selected by filter are read into value
+    inline bool Read(string_view json, const PathFilter& filter, Value& value) noexcept
+    {
+        ParserError error;
+        return Read(json, filter, value, error);
+    }
+
+    inline bool Read(string_view json, const PathFilter& filter, Value& value, ParserError& error) noexcept
+    {
+        StringReader stringReader(json);
+        PathReader pathReader(filter, value);
+        JsonReader jsonReader(pathReader, stringReader);
+        if (jsonReader.Parse())
+        {
+            return true;
+        }
+        else
+        {
+            value.SetInvalid();
+            error = jsonReader.GetError();
+            return false;
+        }
+    }
+
+    template<typename PATH> requires std::is_same_v<PATH, std::filesystem::path>
+    bool Read(const PATH& path, const PathFilter& filter, Value& value) noexcept
+    {
+        ParserError error;
+        return Read(path, filter, value, error);
+    }
+
+    template<typename PATH> requires std::is_same_v<PATH, std::filesystem::path>
+    bool Read(const PATH& path, const PathFilter& filter, Value& value, ParserError& error) noexcept
+    {
+        FileReader fileReader(path);
+        if (!fileReader.IsOpen())
+        {
+            value.SetInvalid();
+            error = ParserError();
+            error.File = path.template string<string_char, std::char_traits<string_char>, string::allocator_type>();
+            error.Error = EJSON_TEXT("cannot open file");
+            return false;
+        }
+
+        PathReader pathReader(filter, value);
+        JsonReader jsonReader(pathReader, fileReader);
+        if (jsonReader.Parse())
+        {
+            return true;
+        }
+        else
+        {
+            value.SetInvalid();
+            error = jsonReader.GetError();
+            error.File = path.template string<string_char, std::char_traits<string_char>, string::allocator_type>();
+            return false;
+        }
+    }
+
     inline void Write(const Value& value, string& str, bool prettify /*= false*/) noexcept
     {
         StringClear(str);
@@ -1998,6 +7418,487 @@ namespace ejson
             valueWriter.Write(value);
         }
     }
+
+    struct LinesRecord
+    {
+        size_t Line = 0;
+        bool Result = false;
+        Value Json;
+        ParserError Error;
+    };
+
+    // Read with the property names of the worker, records of a file share their keys
+    inline bool ReadLine(string_view json, size_t line, const string& file, KeyTable& keyTable, Value& value, ParserError& error) noexcept
+    {
+        StringReader stringReader(json);
+        ValueReader valueReader(value, keyTable);
+        JsonReader jsonReader(valueReader, stringReader);
+        if (jsonReader.Parse())
+            return true;
+        value.SetInvalid();
+        error = jsonReader.GetError();
+        error.Line = (u32)line;
+        error.File = file;
+        return false;
+    }
+
+    template<typename CHAR, typename CALLBACK>
+    void ReadLines(const CHAR* begin, const CHAR* end, const string& file, CALLBACK& callback, const LinesOptions& options) noexcept
+    {
+        const u32 workers = WorkerCount(options.Workers);
+        LinesBatches<CHAR> batches(begin, end, options.BatchSize, 2 * (size_t)workers);
+
+        if (workers == 1)
+        {
+            LinesWorker<CHAR> worker;
+            KeyTable keyTable;
+            size_t batch = 0;
+            while (batches.Claim(batch))
+            {
+                worker.ForEachRecord(batches, batch, [&](size_t line, string_view json)
+                {
+                    Value value;
+                    ParserError error;
+                    bool result = ReadLine(json, line, file, keyTable, value, error);
+                    callback(line, result, value, error);
+                });
+                batches.Release();
+            }
+            return;
+        }
+
+        // workers keep the records of a batch, the calling thread delivers them
+        vector<vector<LinesRecord>> records(batches.Count());
+        vector<std::thread> threads;
+        threads.reserve(workers);
+        for (u32 i = 0; i < workers; ++i)
+        {
+            threads.emplace_back([&]
+            {
+                LinesWorker<CHAR> worker;
+                KeyTable keyTable;
+                size_t batch = 0;
+                while (batches.Claim(batch))
+                {
+                    worker.ForEachRecord(batches, batch, [&](size_t line, string_view json)
+                    {
+                        LinesRecord& record = records[batch].emplace_back();
+                        record.Line = line;
+                        record.Result = ReadLine(json, line, file, keyTable, record.Json, record.Error);
+                    });
+                    batches.Done(batch);
+                }
+            });
+        }
+
+        size_t batch = 0;
+        while (batches.Deliver(batch, options.Ordered))
+        {
+            for (LinesRecord& record : records[batch])
+                callback(record.Line, record.Result, record.Json, record.Error);
+            vector<LinesRecord>().swap(records[batch]);
+            batches.Release();
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    // callback(size_t line, bool result, Value& value, const ParserError& error) is called on the calling
+    // thread for each record, value can be moved away.
+    template<typename CALLBACK>
+    void ReadLines(string_view json, CALLBACK&& callback, const LinesOptions& options /*= LinesOptions()*/) noexcept
+    {
+        ReadLines(json.data(), json.data() + StringSize(json), string(), callback, options);
+    }
+
+    // a regular file is parsed in place from its mapping, false if the file cannot be opened
+    template<typename PATH, typename CALLBACK> requires std::is_same_v<PATH, std::filesystem::path>
+    bool ReadLines(const PATH& path, CALLBACK&& callback, const LinesOptions& options /*= LinesOptions()*/) noexcept
+    {
+        FileReader fileReader(path);
+        if (!fileReader.IsOpen())
+            return false;
+
+        const string file = path.template string<string_char, std::char_traits<string_char>, string::allocator_type>();
+        if (fileReader.IsMapped())
+        {
+            const c_string_view data = fileReader.MappedData();
+            ReadLines(data.data(), data.data() + StringSize(data), file, callback, options);
+            return true;
+        }
+
+        // pipes and devices are read whole first
+        string json;
+        const string_char* begin = nullptr;
+        const string_char* end = nullptr;
+        while (fileReader.Fill(begin, end))
+            StringAdd(json, begin, end);
+        ReadLines(json.data(), json.data() + StringSize(json), file, callback, options);
+        return true;
+    }
+
+    // One worker per listener, records are parsed straight to the listener of their worker.
+    // callback(LISTENER& listener, size_t line, bool result, const ParserError& error) is called on the
+    // worker thread after each record, in input order within a batch.
+    template<typename LISTENER, typename CALLBACK>
+    void ParseLines(string_view json, vector<LISTENER>& listeners, CALLBACK&& callback, const LinesOptions& options /*= LinesOptions()*/) noexcept
+    {
+        LinesBatches<string_char> batches(json.data(), json.data() + StringSize(json), options.BatchSize, (size_t)-1);
+
+        auto work = [&](LISTENER& listener)
+        {
+            LinesWorker<string_char> worker;
+            size_t batch = 0;
+            while (batches.Claim(batch))
+            {
+                worker.ForEachRecord(batches, batch, [&](size_t line, string_view record)
+                {
+                    StringReader stringReader(record);
+                    JsonReader jsonReader(listener, stringReader);
+                    bool result = jsonReader.Parse();
+                    ParserError error = jsonReader.GetError();
+                    if (!result)
+                        error.Line = (u32)line;
+                    callback(listener, line, result, error);
+                });
+            }
+        };
+
+        vector<std::thread> threads;
+        for (size_t i = 1; i < VectorSize(listeners); ++i)
+            threads.emplace_back(work, std::ref(listeners[i]));
+        if (VectorSize(listeners) != 0)
+            work(listeners[0]);
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    inline bool ReadParallel(string_view json, Value& value, const ParallelOptions& options /*= ParallelOptions()*/) noexcept
+    {
+        ParserError error;
+        return ReadParallel(json, value, error, options);
+    }
+
+    // Same result as Read: falls back to Read when the root is not an array, the input is small, or a slice
+    // fails (errors are then reported as Read does).
+    inline bool ReadParallel(string_view json, Value& value, ParserError& error, const ParallelOptions& options /*= ParallelOptions()*/) noexcept
+    {
+        const u32 workers = WorkerCount(options.Workers);
+        const string_char* begin = json.data();
+        const string_char* end = begin + StringSize(json);
+        const string_char* root = SkipWhitespaces(begin, end);
+        if (workers == 1 || StringSize(json) < options.MinSize || root == end || *root != EJSON_TEXT('['))
+            return Read(json, value, error);
+
+        // the calling thread scans for slices then parses with the workers
+        std::mutex mutex;
+        std::condition_variable condition;
+        vector<size_t> commas;
+        bool scanned = false;
+        bool failed = false;
+        size_t nextSlice = 0;
+        vector<vector<std::pair<size_t, Value>>> fragments(workers);
+
+        auto work = [&](vector<std::pair<size_t, Value>>& workerFragments)
+        {
+            while (true)
+            {
+                size_t slice = 0;
+                string_view sliceJson;
+                bool close = false;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    condition.wait(lock, [&] { return failed || scanned || nextSlice < VectorSize(commas); });
+                    if (failed || nextSlice > VectorSize(commas))
+                        return;
+                    slice = nextSlice++;
+                    const size_t sliceBegin = slice == 0 ? 0 : commas[slice - 1] + 1;
+                    const size_t sliceEnd = slice < VectorSize(commas) ? commas[slice] : StringSize(json);
+                    sliceJson = json.substr(sliceBegin, sliceEnd - sliceBegin);
+                    close = slice < VectorSize(commas);
+                }
+
+                Value fragment;
+                ValueReader valueReader(fragment);
+                ArraySliceReader sliceReader(sliceJson, slice != 0, close);
+                JsonReader jsonReader(valueReader, sliceReader);
+                if (!jsonReader.Parse())
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    failed = true;
+                    condition.notify_all();
+                    return;
+                }
+                workerFragments.emplace_back(slice, EJSON_MOVE(fragment));
+            }
+        };
+
+        vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        for (u32 i = 1; i < workers; ++i)
+            threads.emplace_back(work, std::ref(fragments[i]));
+
+        ScanArraySlices(json, options.SliceSize, [&](size_t comma)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            VectorEmplace(commas, EJSON_MOVE(comma));
+            condition.notify_one();
+        });
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            scanned = true;
+            condition.notify_all();
+        }
+
+        work(fragments[0]);
+        for (std::thread& thread : threads)
+            thread.join();
+
+        if (failed)
+            return Read(json, value, error);
+
+        // splice fragments in slice order
+        vector<Value*> slices(VectorSize(commas) + 1);
+        size_t count = 0;
+        for (vector<std::pair<size_t, Value>>& workerFragments : fragments)
+        {
+            for (std::pair<size_t, Value>& fragment : workerFragments)
+            {
+                slices[fragment.first] = &fragment.second;
+                count += VectorSize(fragment.second.AsArray());
+            }
+        }
+
+        vector<Value> elements;
+        elements.reserve(count);
+        for (Value* slice : slices)
+        {
+            for (Value& element : slice->AsArray())
+                VectorEmplace(elements, EJSON_MOVE(element));
+        }
+        value.SetArray(EJSON_MOVE(elements));
+        return true;
+    }
+
+#if EJSON_ARENA
+
+    // Arena
+    //
+    // Chunked bump allocator: allocation moves a position in the current chunk, deallocation does nothing.
+    // Chunks double in size from chunkSize, Reset() rewinds to the first chunk and keeps all of them for the
+    // next use, they go back to the heap when the arena is destroyed.
+    class Arena : public std::pmr::memory_resource
+    {
+    public:
+
+        static constexpr size_t DefaultChunkSize = 64 * 1024;
+
+        Arena(size_t chunkSize = DefaultChunkSize) noexcept
+            : chunkSize(chunkSize == 0 ? 1 : chunkSize)
+        {}
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        ~Arena() noexcept override {}
+
+        void Reset() noexcept
+        {
+            current = 0;
+            position = 0;
+            size = 0;
+        }
+
+        // bytes allocated since the last Reset()
+        size_t Size() const noexcept
+        {
+            return size;
+        }
+
+        // bytes held by the chunks
+        size_t Capacity() const noexcept
+        {
+            size_t capacity = 0;
+            for (const Chunk& chunk : chunks)
+                capacity += chunk.Size;
+            return capacity;
+        }
+
+    private:
+
+        struct Chunk
+        {
+            std::unique_ptr<char[]> Data;
+            size_t Size = 0;
+        };
+
+        static constexpr size_t MaxChunkGrowth = 6;
+
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            while (true)
+            {
+                if (current == chunks.size())
+                {
+                    Chunk chunk;
+                    chunk.Size = std::max(chunkSize << std::min(chunks.size(), MaxChunkGrowth), bytes + alignment);
+                    chunk.Data = std::make_unique_for_overwrite<char[]>(chunk.Size);
+                    chunks.push_back(EJSON_MOVE(chunk));
+                }
+
+                char* data = chunks[current].Data.get();
+                const size_t begin = (size_t)(AlignUp(data + position, alignment) - data);
+                if (begin + bytes <= chunks[current].Size)
+                {
+                    position = begin + bytes;
+                    size += bytes;
+                    return data + begin;
+                }
+
+                // the rest of this chunk is left unused until Reset()
+                ++current;
+                position = 0;
+            }
+        }
+
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        static char* AlignUp(char* pointer, size_t alignment) noexcept
+        {
+            return (char*)(((std::uintptr_t)pointer + alignment - 1) & ~(std::uintptr_t)(alignment - 1));
+        }
+
+        // std::vector, a vector from the thread resource could come from this arena
+        std::vector<Chunk> chunks;
+        size_t chunkSize;
+        size_t current = 0;
+        size_t position = 0;
+        size_t size = 0;
+    };
+
+    // strings, arrays and objects created by the calling thread while the scope is alive come from resource
+    class ArenaScope
+    {
+    public:
+
+        ArenaScope(std::pmr::memory_resource& resource) noexcept
+            : previous(ThreadResource())
+        {
+            ThreadResource() = &resource;
+        }
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+
+        ~ArenaScope() noexcept
+        {
+            ThreadResource() = previous;
+        }
+
+    private:
+
+        std::pmr::memory_resource* previous;
+    };
+
+    // Document
+    //
+    // A Value tree read in an arena: a read makes no heap allocation once the arena has grown to the size of
+    // the documents, Reset() and the destructor release the whole tree at once. Values added later come from
+    // the heap, or from the arena under an ArenaScope on GetArena(). A Value moved out of the document keeps
+    // pointing into the arena, copy it instead (the copy allocates from the thread resource).
+    class Document
+    {
+    public:
+
+        Document(size_t chunkSize = Arena::DefaultChunkSize) noexcept
+            : arena(chunkSize)
+        {}
+
+        Document(const Document&) = delete;
+        Document& operator=(const Document&) = delete;
+
+        Value& GetRoot() noexcept
+        {
+            return root;
+        }
+
+        const Value& GetRoot() const noexcept
+        {
+            return root;
+        }
+
+        Arena& GetArena() noexcept
+        {
+            return arena;
+        }
+
+        // release the tree, the arena keeps its chunks
+        void Reset() noexcept
+        {
+            root.SetInvalid();
+            arena.Reset();
+        }
+
+        bool Read(string_view json) noexcept
+        {
+            ParserError error;
+            return Read(json, error);
+        }
+
+        bool Read(string_view json, ParserError& error) noexcept
+        {
+            Reset();
+            StringReader stringReader(json);
+            return Parse(stringReader, error);
+        }
+
+        template<typename PATH> requires std::is_same_v<PATH, std::filesystem::path>
+        bool Read(const PATH& path, ParserError& error) noexcept
+        {
+            Reset();
+            FileReader fileReader(path);
+            if (!fileReader.IsOpen())
+            {
+                error = ParserError();
+                error.File = path.template string<string_char, std::char_traits<string_char>, string::allocator_type>();
+                error.Error = EJSON_TEXT("cannot open file");
+                return false;
+            }
+            if (Parse(fileReader, error))
+                return true;
+            error.File = path.template string<string_char, std::char_traits<string_char>, string::allocator_type>();
+            return false;
+        }
+
+    private:
+
+        // the readers are created before the scope: their buffers (contexts, key table, token text) keep the
+        // thread resource, only the tree is in the arena
+        template<typename STRING_READER>
+        bool Parse(STRING_READER& stringReader, ParserError& error) noexcept
+        {
+            ValueReader valueReader(root);
+            JsonReader jsonReader(valueReader, stringReader);
+            ArenaScope scope(arena);
+            if (jsonReader.Parse())
+                return true;
+            root.SetInvalid();
+            error = jsonReader.GetError();
+            return false;
+        }
+
+        // root is destroyed before the arena
+        Arena arena;
+        Value root;
+    };
+
+#endif // #if EJSON_ARENA
 }
 
 #if EJSON_IMPL_FILE
@@ -161,6 +161,67 @@ namespace test_parse_number
     }
 }
 
+namespace test_parse_number_exact
+{
+    using namespace ejson;
+
+    // bit exact, same double as the compiler gives the literal
+    void CheckExact(string_view text, double expected)
+    {
+        number result = -1.0;
+        CHECK(ParseNumber(text, result));
+        CHECK(result == expected);
+        CHECK(std::signbit(result) == std::signbit(expected));
+    }
+
+    TEST_CASE("test_parse_number_exact")
+    {
+        // fast path: exact mantissa and power of ten
+        CheckExact(EJSON_TEXT("0.1"), 0.1);
+        CheckExact(EJSON_TEXT("-0"), -0.0);
+        CheckExact(EJSON_TEXT("0.3"), 0.3);
+        CheckExact(EJSON_TEXT("123.456"), 123.456);
+        CheckExact(EJSON_TEXT("-73.98565432"), -73.98565432);
+        CheckExact(EJSON_TEXT("1e22"), 1e22);
+        CheckExact(EJSON_TEXT("9007199254740992"), 9007199254740992.0);
+
+        // Eisel-Lemire
+        CheckExact(EJSON_TEXT("1e23"), 1e23);
+        CheckExact(EJSON_TEXT("9007199254740993"), 9007199254740992.0);
+        CheckExact(EJSON_TEXT("9007199254740995"), 9007199254740996.0);
+        CheckExact(EJSON_TEXT("1.7976931348623157e308"), 1.7976931348623157e308);
+        CheckExact(EJSON_TEXT("2.2250738585072014E-308"), 2.2250738585072014e-308);
+        CheckExact(EJSON_TEXT("2.2250738585072011e-308"), 2.2250738585072011e-308);
+        CheckExact(EJSON_TEXT("4.9e-324"), 4.9e-324);
+        CheckExact(EJSON_TEXT("0.000000000000000000000000000001"), 1e-30);
+        CheckExact(EJSON_TEXT("12345678.87654321e+10"), 12345678.87654321e+10);
+
+        // more than 19 significant digits
+        CheckExact(EJSON_TEXT("3.141592653589793238462643383279"), 3.141592653589793238462643383279);
+        CheckExact(EJSON_TEXT("123456789012345678901234567890"), 123456789012345678901234567890.0);
+        CheckExact(EJSON_TEXT("0.00000000000000000000123456789012345678901234"), 0.00000000000000000000123456789012345678901234);
+        CheckExact(EJSON_TEXT("9007199254740993.000000000000000000001"), 9007199254740994.0);
+
+        // halfway between two doubles, decided by the digits after the 19th
+        CheckExact(EJSON_TEXT("1.00000000000000011102230246251565404236316680908203125"), 1.0);
+        CheckExact(EJSON_TEXT("1.000000000000000111022302462515654042363166809082031250000001"), 1.0000000000000002);
+
+        // out of range
+        CheckExact(EJSON_TEXT("1e400"), std::numeric_limits<double>::infinity());
+        CheckExact(EJSON_TEXT("-1e400"), -std::numeric_limits<double>::infinity());
+        CheckExact(EJSON_TEXT("1e-400"), 0.0);
+        CheckExact(EJSON_TEXT("-1e-400"), -0.0);
+        CheckExact(EJSON_TEXT("0e999999999999"), 0.0);
+
+        // through Read
+        Value value;
+        REQUIRE(Read(EJSON_TEXT("[0.1,-40.74844205,3.141592653589793238462643383279]"), value));
+        CHECK(value[0].AsNumber() == 0.1);
+        CHECK(value[1].AsNumber() == -40.74844205);
+        CHECK(value[2].AsNumber() == 3.141592653589793238462643383279);
+    }
+}
+
 namespace test_parser
 {
     using namespace ejson;
@@ -270,6 +331,2197 @@ namespace test_parser
     }
 }
 
+namespace test_simd
+{
+    using namespace ejson;
+
+    TEST_CASE("test_simd")
+    {
+        // masks match a plain per character test, non ascii never matches ascii
+        string_char input[SimdBlock::Size];
+        for (size_t i = 0; i < SimdBlock::Size; ++i)
+            input[i] = (string_char)((i * 37) % 0x90);
+#if EJSON_WCHAR
+        input[3] = (string_char)0x120;
+        input[17] = (string_char)0x7FFF;
+        input[42] = (string_char)0xFF22;
+#endif
+        SimdBlock block(input);
+        for (u8 c : { u8(' '), u8('"'), u8('\\'), u8('\n'), u8(0x1F), u8(0x22) })
+        {
+            u64 equal = 0;
+            u64 lessEqual = 0;
+            for (size_t i = 0; i < SimdBlock::Size; ++i)
+            {
+                std::make_unsigned_t<string_char> car = input[i];
+                equal |= (u64)(car == c) << i;
+                lessEqual |= (u64)(car <= c) << i;
+            }
+            CHECK(block.Equal(c) == equal);
+            CHECK(block.LessEqual(c) == lessEqual);
+        }
+    }
+
+    TEST_CASE("test_simd_strings")
+    {
+        // long runs are appended at once, escapes and control characters in the middle of blocks
+        string text;
+        for (int i = 0; i < 300; ++i)
+            text += (string_char)(EJSON_TEXT('a') + i % 26);
+        string escaped = text.substr(0, 70) + EJSON_TEXT("\\\"") + text.substr(70, 100) + EJSON_TEXT("\\u0041\t") + text.substr(170);
+
+        Value value;
+        REQUIRE(Read(EJSON_TEXT("[\"") + text + EJSON_TEXT("\",\"") + escaped + EJSON_TEXT("\"]"), value));
+        REQUIRE(value[0].AsString() == text);
+        REQUIRE(value[1].AsString() == escaped);
+
+        ParserError error;
+        REQUIRE_FALSE(Read(EJSON_TEXT("[\n\"") + text + EJSON_TEXT("\\x\"]"), value, error));
+        REQUIRE(error.Error == EJSON_TEXT("invalid escape car"));
+        REQUIRE(error.Line == 2);
+        REQUIRE(error.Column == 1);
+
+        REQUIRE_FALSE(Read(EJSON_TEXT("\"") + text + EJSON_TEXT("\\\""), value, error));
+        REQUIRE(error.Error == EJSON_TEXT("invalid string"));
+    }
+
+    TEST_CASE("test_simd_whitespaces")
+    {
+        // long indentation runs across blocks, error position recovered from newline counts
+        string json = EJSON_TEXT("{\n");
+        for (int i = 0; i < 100; ++i)
+            json += EJSON_TEXT(" ");
+        json += EJSON_TEXT("\"p\":\t\t[\n\n");
+        for (int i = 0; i < 70; ++i)
+            json += EJSON_TEXT("\t");
+        json += EJSON_TEXT("1,\r\n");
+        for (int i = 0; i < 130; ++i)
+            json += EJSON_TEXT(" ");
+        json += EJSON_TEXT("2 ]\n}\n\n  \n");
+
+        Value value;
+        REQUIRE(Read(json, value));
+        REQUIRE(value[EJSON_TEXT("p")][1].AsNumber() == doctest::Approx(2));
+
+        json += EJSON_TEXT("  x");
+        ParserError error;
+        REQUIRE_FALSE(Read(json, value, error));
+        REQUIRE(error.Error == EJSON_TEXT("invalid input after value"));
+        REQUIRE(error.Line == 9);
+        REQUIRE(error.Column == 3);
+    }
+}
+
+namespace test_reader
+{
+    using namespace ejson;
+
+    // legacy per char reader
+    struct CharByCharReader
+    {
+        string_view input;
+        size_t position = 0;
+
+        bool Read(string_char& car) noexcept
+        {
+            if (position == input.size())
+                return false;
+            car = input[position++];
+            return true;
+        }
+    };
+
+    // hands out the input in spans of 1 to 7 characters copied to a buffer, a span is gone after the next Fill
+    struct RandomSpanReader
+    {
+        string_view input;
+        u64 seed = 0;
+        size_t position = 0;
+        string_char span[7] = {};
+
+        bool Fill(const string_char*& begin, const string_char*& end) noexcept
+        {
+            if (position == input.size())
+                return false;
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            const size_t size = std::min<size_t>(1 + (seed >> 33) % 7, input.size() - position);
+            std::copy(input.data() + position, input.data() + position + size, span);
+            position += size;
+            begin = span;
+            end = span + size;
+            return true;
+        }
+    };
+
+    // seeded random documents for differential tests: nested values with escapes, numbers and line endings,
+    // about half of them broken by a few changed characters so errors land anywhere
+    struct RandomJson
+    {
+        u64 seed = 0;
+
+        u32 Next(u32 range) noexcept
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            return (u32)(seed >> 33) % range;
+        }
+
+        void AddSpaces(string& json) noexcept
+        {
+            static const string_char* spaces[] = { EJSON_TEXT(" "), EJSON_TEXT("\n"), EJSON_TEXT("\r\n"), EJSON_TEXT("\t  "), EJSON_TEXT("\r") };
+            if (Next(3) == 0)
+                json += spaces[Next(5)];
+        }
+
+        void AddString(string& json) noexcept
+        {
+            static const string_char* parts[] = { EJSON_TEXT("a"), EJSON_TEXT("text"), EJSON_TEXT("\\\""), EJSON_TEXT("\\\\"), EJSON_TEXT("\\n"), EJSON_TEXT("\\u00e9"), EJSON_TEXT(" "), EJSON_TEXT("]}"), EJSON_TEXT(",:") };
+            json += EJSON_TEXT('"');
+            for (u32 i = Next(4); i != 0; --i)
+                json += parts[Next(9)];
+            json += EJSON_TEXT('"');
+        }
+
+        void AddValue(string& json, int depth) noexcept
+        {
+            static const string_char* numbers[] = { EJSON_TEXT("0"), EJSON_TEXT("-12"), EJSON_TEXT("3.25"), EJSON_TEXT("1e5"), EJSON_TEXT("-0.5E-3"), EJSON_TEXT("12345678901234567890") };
+            AddSpaces(json);
+            switch (Next(depth < 4 ? 9 : 6))
+            {
+                case 0: json += EJSON_TEXT("null"); break;
+                case 1: json += EJSON_TEXT("true"); break;
+                case 2: json += EJSON_TEXT("false"); break;
+                case 3: json += numbers[Next(6)]; break;
+                case 4:
+                case 5: AddString(json); break;
+                case 6:
+                case 7: AddArray(json, Next(5), depth); break;
+                default:
+                {
+                    json += EJSON_TEXT('{');
+                    for (u32 i = 0, count = Next(4); i < count; ++i)
+                    {
+                        if (i != 0)
+                            json += EJSON_TEXT(',');
+                        AddSpaces(json);
+                        AddString(json);
+                        AddSpaces(json);
+                        json += EJSON_TEXT(':');
+                        AddValue(json, depth + 1);
+                    }
+                    AddSpaces(json);
+                    json += EJSON_TEXT('}');
+                    break;
+                }
+            }
+            AddSpaces(json);
+        }
+
+        void AddArray(string& json, u32 count, int depth) noexcept
+        {
+            json += EJSON_TEXT('[');
+            for (u32 i = 0; i < count; ++i)
+            {
+                if (i != 0)
+                    json += EJSON_TEXT(',');
+                AddValue(json, depth + 1);
+            }
+            AddSpaces(json);
+            json += EJSON_TEXT(']');
+        }
+
+        // a top level array of elements values when elements is not 0
+        string Document(u32 elements = 0) noexcept
+        {
+            string json;
+            if (elements != 0)
+            {
+                AddSpaces(json);
+                AddArray(json, elements, 0);
+                AddSpaces(json);
+            }
+            else
+            {
+                AddValue(json, 0);
+            }
+
+            static const string_char changes[] = EJSON_TEXT("{}[],:\"\\ 1e-.\n");
+            if (Next(2) == 0)
+            {
+                for (u32 i = 1 + Next(2); i != 0 && !json.empty(); --i)
+                {
+                    const size_t position = Next((u32)json.size());
+                    const string_char change = changes[Next((u32)(sizeof(changes) / sizeof(string_char) - 1))];
+                    switch (Next(3))
+                    {
+                        case 0: json.erase(position, 1); break;
+                        case 1: json.insert(json.begin() + position, change); break;
+                        default: json[position] = change; break;
+                    }
+                }
+            }
+            return json;
+        }
+    };
+
+    TEST_CASE("test_reader")
+    {
+        // StringReader hands out the whole input as one span
+        {
+            StringReader stringReader(EJSON_TEXT("[1]"));
+            const string_char* begin = nullptr;
+            const string_char* end = nullptr;
+            REQUIRE(stringReader.Fill(begin, end));
+            REQUIRE(string_view(begin, end - begin) == EJSON_TEXT("[1]"));
+            REQUIRE_FALSE(stringReader.Fill(begin, end));
+        }
+
+        // char reader through CharReader adapter
+        {
+            CharByCharReader charReader{ EJSON_TEXT("{ \"p0\" : [true, 12, \"hello\"] }") };
+            Value jsonValue;
+            ValueReader valueReader(jsonValue);
+            JsonReader<ValueReader, CharByCharReader> jsonReader(valueReader, charReader);
+            REQUIRE(jsonReader.Parse());
+            REQUIRE(jsonValue[EJSON_TEXT("p0")][2].AsString() == EJSON_TEXT("hello"));
+        }
+
+        // stream larger than the reader buffer, tokens split across spans
+        {
+            string json = EJSON_TEXT("[");
+            for (int i = 0; i < 2000; ++i)
+            {
+                if (i != 0)
+                    json += EJSON_TEXT(",\r\n");
+                json += EJSON_TEXT("{\"name\":\"value\",\"id\":1234.5}");
+            }
+            json += EJSON_TEXT("]");
+
+#if EJSON_WCHAR
+            std::wstringstream stream(json);
+#else
+            std::stringstream stream(json);
+#endif
+            Value jsonValue;
+            REQUIRE(Read(stream, jsonValue));
+            REQUIRE(jsonValue.AsArray().size() == 2000);
+            REQUIRE(jsonValue[1999][EJSON_TEXT("name")].AsString() == EJSON_TEXT("value"));
+            REQUIRE(jsonValue[1999][EJSON_TEXT("id")].AsNumber() == doctest::Approx(1234.5));
+
+            string output;
+            Write(jsonValue, output);
+            string expected = json;
+            std::erase(expected, EJSON_TEXT('\r'));
+            std::erase(expected, EJSON_TEXT('\n'));
+            REQUIRE(output == expected);
+        }
+
+        // error positions are counted when a span is dropped: the failing string starts spans before the error
+        {
+            string json = EJSON_TEXT("[\r\n");
+            for (int i = 0; i < 100; ++i)
+                json += EJSON_TEXT("  \"value\",\n");
+            json += EJSON_TEXT("  \"") + string(1000, EJSON_TEXT('x')) + EJSON_TEXT("\\x\"]");
+
+            CharByCharReader charReader{ json };
+            Value jsonValue;
+            ValueReader valueReader(jsonValue);
+            JsonReader<ValueReader, CharByCharReader> jsonReader(valueReader, charReader);
+            REQUIRE_FALSE(jsonReader.Parse());
+            REQUIRE(jsonReader.GetError().Error == EJSON_TEXT("invalid escape car"));
+            REQUIRE(jsonReader.GetError().Line == 102);
+            REQUIRE(jsonReader.GetError().Column == 3);
+
+            ParserError error;
+            REQUIRE_FALSE(Read(json, jsonValue, error));
+            REQUIRE(error.Line == 102);
+            REQUIRE(error.Column == 3);
+        }
+
+        // a duplicated key replaces the previous value, also by or with an array or an object
+        {
+            Value jsonValue;
+            string output;
+            REQUIRE(Read(EJSON_TEXT("{\"a\":1,\"a\":[2]}"), jsonValue));
+            Write(jsonValue, output);
+            REQUIRE(output == EJSON_TEXT("{\"a\":[2]}"));
+
+            REQUIRE(Read(EJSON_TEXT("[{\"a\":[1,[2]],\"b\":{\"c\":[3],\"c\":{\"d\":5}},\"a\":\"x\"},4]"), jsonValue));
+            output.clear();
+            Write(jsonValue, output);
+            REQUIRE(output == EJSON_TEXT("[{\"a\":\"x\",\"b\":{\"c\":{\"d\":5}}},4]"));
+        }
+    }
+
+    // spans of 1 to 7 characters give the value and the error position of a single span
+    TEST_CASE("test_reader_random_spans")
+    {
+        RandomJson random{ 0x2545F4914F6CDD1Dull };
+        for (int test = 0; test < 3000; ++test)
+        {
+            const string json = random.Document();
+
+            Value expected;
+            ParserError expectedError;
+            const bool expectedResult = Read(json, expected, expectedError);
+
+            RandomSpanReader spanReader{ json, random.seed };
+            Value value;
+            ValueReader valueReader(value);
+            JsonReader jsonReader(valueReader, spanReader);
+            REQUIRE(jsonReader.Parse() == expectedResult);
+            REQUIRE(jsonReader.GetError().Error == expectedError.Error);
+            REQUIRE(jsonReader.GetError().Line == expectedError.Line);
+            REQUIRE(jsonReader.GetError().Column == expectedError.Column);
+            if (expectedResult)
+            {
+                string expectedJson;
+                string valueJson;
+                Write(expected, expectedJson);
+                Write(value, valueJson);
+                REQUIRE(valueJson == expectedJson);
+            }
+        }
+    }
+}
+
+namespace test_zero_copy
+{
+    using namespace ejson;
+
+    // count strings handed out as views on the input
+    struct ViewListener
+    {
+        string_view input;
+        int views = 0;
+        int copies = 0;
+
+        void Check(const string_view& str) noexcept
+        {
+            if (str.data() >= input.data() && str.data() + str.size() <= input.data() + input.size())
+                ++views;
+            else
+                ++copies;
+        }
+
+        void ObjectBegin() noexcept {}
+        void ObjectEnd() noexcept {}
+        void PropertyBegin(const string_view& name) noexcept { Check(name); }
+        void PropertyEnd() noexcept {}
+        void ArrayBegin() noexcept {}
+        void ArrayEnd() noexcept {}
+        void ValueBool(bool) noexcept {}
+        void ValueNull() noexcept {}
+        void ValueString(const string_view& str) noexcept { Check(str); }
+        void ValueNumber(const string_view&) noexcept {}
+    };
+
+    TEST_CASE("test_zero_copy")
+    {
+        string_view json = EJSON_TEXT("{\"name\":\"John\",\"quote\":\"a \\\"b\\\"\",\"music\":[\"punk\",\"\"]}");
+        ViewListener listener{ json };
+        StringReader stringReader(json);
+        JsonReader jsonReader(listener, stringReader);
+        REQUIRE(jsonReader.Parse());
+        REQUIRE(listener.views == 6);
+        REQUIRE(listener.copies == 1);
+    }
+}
+
+namespace test_file
+{
+    using namespace ejson;
+
+    TEST_CASE("test_file")
+    {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / "ejson_test_file.json";
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << "{\"FirstName\":\"John\",\r\n\"Music\":[\"punk\",\"country\",\"folk\"]}";
+        }
+
+        {
+            Value value;
+            REQUIRE(Read(path, value));
+            REQUIRE(value[EJSON_TEXT("FirstName")].AsString() == EJSON_TEXT("John"));
+            REQUIRE(value[EJSON_TEXT("Music")][2].AsString() == EJSON_TEXT("folk"));
+        }
+
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << "{\n\"FirstName\" : \"John\" \"LastName\"}";
+        }
+
+        {
+            Value value;
+            ParserError error;
+            REQUIRE_FALSE(Read(path, value, error));
+            REQUIRE(value.IsInvalid());
+            REQUIRE(error.Error == EJSON_TEXT("unexpected token after object property"));
+            REQUIRE(error.Line == 2);
+            REQUIRE(error.Column == 22);
+            REQUIRE(error.File == path.string<string_char, std::char_traits<string_char>, string::allocator_type>());
+        }
+
+        // UTF-8 is decoded in wchar_t mode, sequences cut between two chunks included
+        const char* utf8 = "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";
+#if EJSON_WCHAR
+        const string text = L"\u00E9\u20AC\U0001F600";
+#else
+        const string text = utf8;
+#endif
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << "{\"name\":\"caf" << utf8 << "\"}";
+        }
+
+        {
+            Value value;
+            REQUIRE(Read(path, value));
+            REQUIRE(value[EJSON_TEXT("name")].AsString() == EJSON_TEXT("caf") + text);
+        }
+
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << "[\"x";
+            for (int i = 0; i < 20000; ++i)
+                file << utf8;
+            file << "\"]";
+        }
+
+        {
+            string expected = EJSON_TEXT("x");
+            for (int i = 0; i < 20000; ++i)
+                expected += text;
+            Value value;
+            REQUIRE(Read(path, value));
+            REQUIRE(value[0].AsString() == expected);
+        }
+
+#if EJSON_WCHAR
+        // invalid and truncated sequences
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << "[\"a\xFF" "b\xC3\", \"\xE2\x82\", \"\xC0\xAF\xED\xA0\x80\"]";
+        }
+
+        {
+            Value value;
+            REQUIRE(Read(path, value));
+            REQUIRE(value[0].AsString() == L"a\uFFFDb\uFFFD");
+            REQUIRE(value[1].AsString() == L"\uFFFD");
+            REQUIRE(value[2].AsString() == L"\uFFFD\uFFFD\uFFFD");
+        }
+#endif
+
+        std::filesystem::remove(path);
+
+        {
+            Value value;
+            ParserError error;
+            REQUIRE_FALSE(Read(path, value, error));
+            REQUIRE(error.Error == EJSON_TEXT("cannot open file"));
+        }
+    }
+}
+
+namespace test_index
+{
+    using namespace ejson;
+
+    // records callbacks to compare both engines event by event
+    struct LogListener
+    {
+        string log;
+
+        void ObjectBegin() noexcept { log += EJSON_TEXT("{"); }
+        void ObjectEnd() noexcept { log += EJSON_TEXT("}"); }
+        void PropertyBegin(const string_view& name) noexcept { log += EJSON_TEXT("P:"); log += name; }
+        void PropertyEnd() noexcept { log += EJSON_TEXT(";"); }
+        void ArrayBegin() noexcept { log += EJSON_TEXT("["); }
+        void ArrayEnd() noexcept { log += EJSON_TEXT("]"); }
+        void ValueBool(bool b) noexcept { log += b ? EJSON_TEXT("T") : EJSON_TEXT("F"); }
+        void ValueNull() noexcept { log += EJSON_TEXT("N"); }
+        void ValueString(const string_view& str) noexcept { log += EJSON_TEXT("S:"); log += str; }
+        void ValueNumber(const string_view& str) noexcept { log += EJSON_TEXT("#:"); log += str; }
+    };
+
+    void CheckSame(const string& json)
+    {
+        LogListener expected;
+        StringReader stringReader(json);
+        JsonReader jsonReader(expected, stringReader);
+        bool expectedResult = jsonReader.Parse();
+
+        LogListener listener;
+        JsonIndexReader indexReader(listener, json);
+        REQUIRE(indexReader.Parse() == expectedResult);
+        REQUIRE(listener.log == expected.log);
+        REQUIRE(indexReader.GetError().Error == jsonReader.GetError().Error);
+        REQUIRE(indexReader.GetError().Line == jsonReader.GetError().Line);
+        REQUIRE(indexReader.GetError().Column == jsonReader.GetError().Column);
+    }
+
+    TEST_CASE("test_index_escapes")
+    {
+        // escaped characters match a plain walk over the backslashes, runs crossing blocks included
+        u64 seed = 0x9E3779B97F4A7C15ull;
+        for (int test = 0; test < 1000; ++test)
+        {
+            u64 backslash[2];
+            for (u64& mask : backslash)
+            {
+                seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+                mask = seed & (seed >> 7) & (seed >> 13);
+                if (test % 3 == 0)
+                    mask |= 0xFF00000000000000ull;
+            }
+
+            u64 expected[2] = {};
+            bool escaping = false;
+            for (int i = 0; i < 128; ++i)
+            {
+                if (escaping)
+                {
+                    expected[i / 64] |= 1ull << (i % 64);
+                    escaping = false;
+                }
+                else if ((backslash[i / 64] >> (i % 64)) & 1)
+                {
+                    escaping = true;
+                }
+            }
+
+            u64 escapedCarry = 0;
+            CHECK(FindEscaped(backslash[0], escapedCarry) == expected[0]);
+            CHECK(FindEscaped(backslash[1], escapedCarry) == expected[1]);
+        }
+    }
+
+    TEST_CASE("test_index")
+    {
+        string text;
+        for (int i = 0; i < 150; ++i)
+            text += (string_char)(EJSON_TEXT('a') + i % 26);
+        string spaces(100, EJSON_TEXT(' '));
+
+        for (const string& json : {
+            string(EJSON_TEXT("{\"name\":\"John\",\"age\":42,\"music\":[\"punk\",true,false,null,-1.5],\"empty\":{}}")),
+            EJSON_TEXT("[\r\n  \"") + text + EJSON_TEXT("\",") + spaces + EJSON_TEXT("\"a\\\\\\\"b\\u1234\",\n\"") + text + EJSON_TEXT("\\\\\\\\\"]"),
+            string(EJSON_TEXT("[1-2,truefalse, 3.4.5]")),
+            string(EJSON_TEXT("\"line\r\nending\"")),
+            string(EJSON_TEXT("")),
+            string(EJSON_TEXT("[1,")),
+            string(EJSON_TEXT("{\"a\" 1}")),
+            string(EJSON_TEXT("[nul]")),
+            string(EJSON_TEXT("[1.]")),
+            string(EJSON_TEXT("[\"a\\x\"]")),
+            string(EJSON_TEXT("[\"\\u12\"]")),
+            string(EJSON_TEXT("[\"abc")),
+            string(EJSON_TEXT("{}\n  x")),
+            string(EJSON_TEXT("[\r 1]")),
+            EJSON_TEXT("[\"") + text + EJSON_TEXT("\",\n") + spaces + EJSON_TEXT("?]") })
+        {
+            CheckSame(json);
+        }
+    }
+}
+
+namespace test_push
+{
+    using namespace ejson;
+    using test_index::LogListener;
+    using test_reader::RandomJson;
+
+    // feeds json in chunks of chunkSize characters, result must match JsonReader on the whole input
+    void CheckChunks(const string& json, size_t chunkSize)
+    {
+        LogListener expected;
+        StringReader stringReader(json);
+        JsonReader jsonReader(expected, stringReader);
+        bool expectedResult = jsonReader.Parse();
+
+        LogListener listener;
+        JsonPushReader pushReader(listener);
+        for (size_t i = 0; i < json.size(); i += chunkSize)
+            pushReader.Feed(string_view(json.data() + i, std::min(chunkSize, json.size() - i)));
+        REQUIRE((pushReader.Finish() == PushStatus::Done) == expectedResult);
+        REQUIRE(listener.log == expected.log);
+        REQUIRE(pushReader.GetError().Error == jsonReader.GetError().Error);
+        REQUIRE(pushReader.GetError().Line == jsonReader.GetError().Line);
+        REQUIRE(pushReader.GetError().Column == jsonReader.GetError().Column);
+    }
+
+    TEST_CASE("test_push")
+    {
+        for (const string& json : {
+            string(EJSON_TEXT("{\"name\":\"John\",\"age\":42,\"music\":[\"punk\",true,false,null,-1.5],\"a\\\\\\\"b\\u1234\":[[],[1 2,]]}")),
+            string(EJSON_TEXT("[1-2,truefalse, 3.4.5]")),
+            string(EJSON_TEXT("\"line\r\nending\"\r\n")),
+            string(EJSON_TEXT("12")),
+            string(EJSON_TEXT("")),
+            string(EJSON_TEXT("[1,")),
+            string(EJSON_TEXT("{\"a\" 1}")),
+            string(EJSON_TEXT("[nul]")),
+            string(EJSON_TEXT("[1.]")),
+            string(EJSON_TEXT("[-\r\n1]")),
+            string(EJSON_TEXT("[\"a\\x\"]")),
+            string(EJSON_TEXT("[\"\\u12\"]")),
+            string(EJSON_TEXT("[\"abc")),
+            string(EJSON_TEXT("[1]\n  x")),
+            string(EJSON_TEXT("[1]\r")),
+            string(EJSON_TEXT("[\r 1]")) })
+        {
+            for (size_t chunkSize = 1; chunkSize <= json.size() + 1; ++chunkSize)
+                CheckChunks(json, chunkSize);
+        }
+    }
+
+    // random documents fed in chunks of random sizes, mostly small so tokens are cut everywhere
+    TEST_CASE("test_push_random")
+    {
+        RandomJson random{ 0x853C49E6748FEA9Bull };
+        for (int test = 0; test < 3000; ++test)
+        {
+            const string json = random.Document();
+
+            LogListener expected;
+            StringReader stringReader(json);
+            JsonReader jsonReader(expected, stringReader);
+            const bool expectedResult = jsonReader.Parse();
+
+            LogListener listener;
+            JsonPushReader pushReader(listener);
+            for (size_t i = 0; i < json.size();)
+            {
+                const size_t chunkSize = random.Next(4) == 0 ? 1 + random.Next(64) : 1 + random.Next(5);
+                const size_t size = std::min(chunkSize, json.size() - i);
+                pushReader.Feed(string_view(json.data() + i, size));
+                i += size;
+            }
+            REQUIRE((pushReader.Finish() == PushStatus::Done) == expectedResult);
+            REQUIRE(listener.log == expected.log);
+            REQUIRE(pushReader.GetError().Error == jsonReader.GetError().Error);
+            REQUIRE(pushReader.GetError().Line == jsonReader.GetError().Line);
+            REQUIRE(pushReader.GetError().Column == jsonReader.GetError().Column);
+        }
+    }
+
+    TEST_CASE("test_push_status")
+    {
+        LogListener listener;
+        JsonPushReader pushReader(listener);
+        REQUIRE(pushReader.Feed(EJSON_TEXT("{\"na")) == PushStatus::NeedMoreInput);
+        REQUIRE(listener.log == EJSON_TEXT("{"));
+        REQUIRE(pushReader.Feed(EJSON_TEXT("me\":12")) == PushStatus::NeedMoreInput);
+        REQUIRE(listener.log == EJSON_TEXT("{P:name"));
+        REQUIRE(pushReader.Feed(EJSON_TEXT("3}")) == PushStatus::Done);
+        REQUIRE(listener.log == EJSON_TEXT("{P:name#:123;}"));
+        REQUIRE(pushReader.Feed(EJSON_TEXT(" \n")) == PushStatus::Done);
+        REQUIRE(pushReader.Finish() == PushStatus::Done);
+
+        JsonPushReader errorReader(listener);
+        REQUIRE(errorReader.Feed(EJSON_TEXT("[1,\n")) == PushStatus::NeedMoreInput);
+        REQUIRE(errorReader.Feed(EJSON_TEXT(" :")) == PushStatus::Error);
+        REQUIRE(errorReader.GetError().Error == EJSON_TEXT("unexpected value"));
+        REQUIRE(errorReader.GetError().Line == 2);
+        REQUIRE(errorReader.GetError().Column == 2);
+        REQUIRE(errorReader.Feed(EJSON_TEXT("2]")) == PushStatus::Error);
+    }
+}
+
+namespace test_lines
+{
+    using namespace ejson;
+
+    struct Record
+    {
+        size_t Line = 0;
+        bool Result = false;
+        string Json;
+        string Error;
+
+        bool operator<(const Record& other) const { return Line < other.Line; }
+        bool operator==(const Record& other) const { return Line == other.Line && Result == other.Result && Json == other.Json && Error == other.Error; }
+    };
+
+    vector<Record> ReadAll(string_view json, const LinesOptions& options)
+    {
+        vector<Record> records;
+        ReadLines(json, [&](size_t line, bool result, Value& value, const ParserError& error)
+        {
+            Record record;
+            record.Line = line;
+            record.Result = result;
+            if (result)
+                Write(value, record.Json);
+            record.Error = error.Error;
+            if (!result)
+                REQUIRE(error.Line == line);
+            records.push_back(record);
+        }, options);
+        return records;
+    }
+
+    // counts values, reused for every record of its worker
+    struct CountListener
+    {
+        size_t values = 0;
+        size_t records = 0;
+        size_t errors = 0;
+
+        void ObjectBegin() noexcept {}
+        void ObjectEnd() noexcept {}
+        void PropertyBegin(const string_view&) noexcept {}
+        void PropertyEnd() noexcept {}
+        void ArrayBegin() noexcept {}
+        void ArrayEnd() noexcept {}
+        void ValueBool(bool) noexcept { ++values; }
+        void ValueNull() noexcept { ++values; }
+        void ValueString(const string_view&) noexcept { ++values; }
+        void ValueNumber(const string_view&) noexcept { ++values; }
+    };
+
+    TEST_CASE("test_lines")
+    {
+        string json;
+        for (int i = 0; i < 200; ++i)
+        {
+            string id;
+            for (char c : std::to_string(i))
+                id += (string_char)c;
+
+            if (i % 17 == 3)
+                json += EJSON_TEXT("{\"id\":1 2}\n");
+            else if (i % 13 == 5)
+                json += EJSON_TEXT("  \t\r\n");
+            else
+                json += EJSON_TEXT("{\"id\":") + id + EJSON_TEXT(",\"tags\":[\"a\",\"b\"]}\r\n");
+        }
+        json += EJSON_TEXT("\n[\"no line ending\"]");
+
+        LinesOptions options;
+        options.Workers = 1;
+        vector<Record> expected = ReadAll(json, options);
+        REQUIRE(expected.size() == 200 - 14 + 1);
+        REQUIRE(expected[0].Line == 1);
+        REQUIRE(expected[0].Json == EJSON_TEXT("{\"id\":0,\"tags\":[\"a\",\"b\"]}"));
+        REQUIRE(expected[3].Line == 4);
+        REQUIRE_FALSE(expected[3].Result);
+        REQUIRE(expected[3].Error == EJSON_TEXT("unexpected token after object property"));
+        REQUIRE(expected[5].Line == 7);
+        REQUIRE(expected.back().Line == 202);
+        REQUIRE(expected.back().Json == EJSON_TEXT("[\"no line ending\"]"));
+
+        for (size_t batchSize : { 1, 7, 64, 1000, 100000 })
+        {
+            options.BatchSize = batchSize;
+            options.Workers = 1;
+            REQUIRE(ReadAll(json, options) == expected);
+
+            options.Workers = 4;
+            options.Ordered = true;
+            REQUIRE(ReadAll(json, options) == expected);
+
+            options.Ordered = false;
+            vector<Record> completed = ReadAll(json, options);
+            std::sort(completed.begin(), completed.end());
+            REQUIRE(completed == expected);
+
+            vector<CountListener> listeners(3);
+            std::mutex mutex;
+            size_t lineSum = 0;
+            ParseLines(json, listeners, [&](CountListener& listener, size_t line, bool result, const ParserError&)
+            {
+                ++listener.records;
+                if (!result)
+                    ++listener.errors;
+                std::lock_guard<std::mutex> lock(mutex);
+                lineSum += line;
+            }, options);
+
+            size_t expectedLineSum = 0;
+            for (const Record& record : expected)
+                expectedLineSum += record.Line;
+            REQUIRE(lineSum == expectedLineSum);
+            REQUIRE(listeners[0].records + listeners[1].records + listeners[2].records == expected.size());
+            REQUIRE(listeners[0].errors + listeners[1].errors + listeners[2].errors == 12);
+        }
+
+        REQUIRE(ReadAll(EJSON_TEXT(""), options).empty());
+    }
+
+    TEST_CASE("test_lines_file")
+    {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / "ejson_test_lines.json";
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << "{\"a\":1}\n{\"a\":2}\r\n\n[x]\n\"caf\xC3\xA9\"";
+        }
+
+        vector<Record> records;
+        REQUIRE(ReadLines(path, [&](size_t line, bool result, Value& value, const ParserError& error)
+        {
+            Record record;
+            record.Line = line;
+            record.Result = result;
+            if (result)
+                Write(value, record.Json);
+            else
+                REQUIRE(error.File == path.string<string_char, std::char_traits<string_char>, string::allocator_type>());
+            records.push_back(record);
+        }));
+        REQUIRE(records.size() == 4);
+        REQUIRE(records[1].Json == EJSON_TEXT("{\"a\":2}"));
+        REQUIRE(records[2].Line == 4);
+        REQUIRE_FALSE(records[2].Result);
+#if EJSON_WCHAR
+        REQUIRE(records[3].Json == L"\"caf\u00E9\"");
+#else
+        REQUIRE(records[3].Json == "\"caf\xC3\xA9\"");
+#endif
+
+        std::filesystem::remove(path);
+        REQUIRE_FALSE(ReadLines(path, [](size_t, bool, Value&, const ParserError&) {}));
+    }
+}
+
+namespace test_parallel
+{
+    using namespace ejson;
+    using test_reader::RandomJson;
+
+    // ReadParallel must give the same value or the same error as Read
+    void CheckSame(const string& json, size_t sliceSize, u32 workers = 3)
+    {
+        Value expected;
+        ParserError expectedError;
+        bool expectedResult = Read(json, expected, expectedError);
+
+        ParallelOptions options;
+        options.Workers = workers;
+        options.MinSize = 0;
+        options.SliceSize = sliceSize;
+        Value value;
+        ParserError error;
+        REQUIRE(ReadParallel(json, value, error, options) == expectedResult);
+        REQUIRE(error.Error == expectedError.Error);
+        REQUIRE(error.Line == expectedError.Line);
+        REQUIRE(error.Column == expectedError.Column);
+        if (expectedResult)
+        {
+            string expectedJson;
+            string valueJson;
+            Write(expected, expectedJson);
+            Write(value, valueJson);
+            REQUIRE(valueJson == expectedJson);
+        }
+    }
+
+    TEST_CASE("test_parallel")
+    {
+        string records = EJSON_TEXT(" [");
+        for (int i = 0; i < 300; ++i)
+        {
+            if (i != 0)
+                records += EJSON_TEXT(",");
+            records += EJSON_TEXT("{\"name\":\"a,]}[{\\\"\",\"tags\":[1,[2,3],{\"x\":null}]}\r\n  ");
+            if (i % 7 == 0)
+                records += EJSON_TEXT("12,\"\\\\\",true ");
+        }
+        records += EJSON_TEXT("]\n");
+
+        for (const string& json : {
+            records,
+            records.substr(0, records.size() - 4),
+            records + EJSON_TEXT("x"),
+            EJSON_TEXT("[1,,2,") + records,
+            string(EJSON_TEXT("[1 2,3,]")),
+            string(EJSON_TEXT("[1,2,3,4,5,6,7,8,9,]")),
+            string(EJSON_TEXT("[[1},2,3,4,5,6]")),
+            string(EJSON_TEXT("[1,2,3\r,4,5,6]")),
+            string(EJSON_TEXT("{\"a\":[1,2,3,4,5,6,7,8,9]}")),
+            string(EJSON_TEXT("[]")),
+            string(EJSON_TEXT("")) })
+        {
+            for (size_t sliceSize : { 1, 5, 64, 100000 })
+                CheckSame(json, sliceSize);
+        }
+    }
+
+    // random top level arrays, half of them broken, with random worker counts and slice sizes
+    TEST_CASE("test_parallel_random")
+    {
+        RandomJson random{ 0xDA942042E4DD58B5ull };
+        for (int test = 0; test < 500; ++test)
+        {
+            const string json = random.Document(1 + random.Next(40));
+            CheckSame(json, 1 + random.Next(128), 1 + random.Next(8));
+        }
+    }
+}
+
+namespace test_skip
+{
+    using namespace ejson;
+    using test_index::LogListener;
+    using test_reader::CharByCharReader;
+
+    // skips the properties named "skip" and, when asked, every array
+    struct SkipListener : LogListener
+    {
+        bool skipArrays = false;
+
+        Listen PropertyBegin(const string_view& name) noexcept
+        {
+            LogListener::PropertyBegin(name);
+            return name == EJSON_TEXT("skip") ? Listen::Skip : Listen::Continue;
+        }
+
+        Listen ArrayBegin() noexcept
+        {
+            LogListener::ArrayBegin();
+            return skipArrays ? Listen::Skip : Listen::Continue;
+        }
+    };
+
+    // every engine skips the same and reports the same errors, returns the JsonReader log
+    string CheckSkips(const string& json, bool skipArrays, const string& error = string())
+    {
+        SkipListener expected;
+        expected.skipArrays = skipArrays;
+        StringReader stringReader(json);
+        JsonReader jsonReader(expected, stringReader);
+        const bool expectedResult = jsonReader.Parse();
+        REQUIRE(expectedResult == error.empty());
+        REQUIRE(jsonReader.GetError().Error == error);
+
+        auto checkSame = [&](bool result, const ParserError& parserError, const SkipListener& listener)
+        {
+            REQUIRE(result == expectedResult);
+            REQUIRE(listener.log == expected.log);
+            REQUIRE(parserError.Error == jsonReader.GetError().Error);
+            REQUIRE(parserError.Line == jsonReader.GetError().Line);
+            REQUIRE(parserError.Column == jsonReader.GetError().Column);
+        };
+
+        {
+            SkipListener listener;
+            listener.skipArrays = skipArrays;
+            CharByCharReader charReader{ json };
+            JsonReader<SkipListener, CharByCharReader> charJsonReader(listener, charReader);
+            const bool result = charJsonReader.Parse();
+            checkSame(result, charJsonReader.GetError(), listener);
+        }
+        {
+            SkipListener listener;
+            listener.skipArrays = skipArrays;
+            JsonIndexReader indexReader(listener, json);
+            const bool result = indexReader.Parse();
+            checkSame(result, indexReader.GetError(), listener);
+        }
+        for (size_t chunkSize : { (size_t)1, (size_t)3, (size_t)64, json.size() + 1 })
+        {
+            SkipListener listener;
+            listener.skipArrays = skipArrays;
+            JsonPushReader pushReader(listener);
+            for (size_t i = 0; i < json.size(); i += chunkSize)
+                pushReader.Feed(string_view(json.data() + i, std::min(chunkSize, json.size() - i)));
+            const bool result = pushReader.Finish() == PushStatus::Done;
+            checkSame(result, pushReader.GetError(), listener);
+        }
+        return expected.log;
+    }
+
+    TEST_CASE("test_skip")
+    {
+        const string json = EJSON_TEXT("{\"a\":1,\"skip\":{\"b\":[1,\"]}\",{\"c\":\"\\\"}\\\\\"}]},\"list\":[1,[2]],\"skip\":\"x\",\"t\":true}");
+        REQUIRE(CheckSkips(json, false) == EJSON_TEXT("{P:a#:1;P:skipP:list[#:1[#:2]];P:skipP:tT;}"));
+        REQUIRE(CheckSkips(json, true) == EJSON_TEXT("{P:a#:1;P:skipP:list[;P:skipP:tT;}"));
+        REQUIRE(CheckSkips(EJSON_TEXT("[[1,{\"a\":2}],3]"), true) == EJSON_TEXT("["));
+
+        // strings and backslash runs longer than a simd block inside the skipped value
+        const string_view pieces[] = { EJSON_TEXT("["), EJSON_TEXT("{"), EJSON_TEXT("\\\""), EJSON_TEXT("\\\\"), EJSON_TEXT("}") };
+        string text;
+        for (int i = 0; i < 150; ++i)
+            text += pieces[i % 5];
+        const string large = EJSON_TEXT("{\"skip\":[\"") + text + EJSON_TEXT("\\\\\",") + string(100, EJSON_TEXT(' ')) + EJSON_TEXT("{\"k\":\"") + text + EJSON_TEXT("\\\"\"}],\"n\":null}");
+        REQUIRE(CheckSkips(large, false) == EJSON_TEXT("{P:skipP:nN;}"));
+
+        // skipped values are checked for closed strings and balanced brackets only
+        REQUIRE(CheckSkips(EJSON_TEXT("{\"skip\":[1 2 : {]],\"n\":null}"), false) == EJSON_TEXT("{P:skipP:nN;}"));
+        CheckSkips(EJSON_TEXT("{\"skip\":[1,2"), false, EJSON_TEXT("invalid skipped value"));
+        CheckSkips(EJSON_TEXT("{\"skip\":[\"]}"), false, EJSON_TEXT("invalid skipped value"));
+        CheckSkips(EJSON_TEXT("[1,\n[2,\"a]\n"), true, EJSON_TEXT("invalid skipped value"));
+        CheckSkips(EJSON_TEXT("{\"skip\":}"), false, EJSON_TEXT("unexpected value"));
+        CheckSkips(EJSON_TEXT("{\"skip\":[]]"), false, EJSON_TEXT("unexpected token after object property"));
+
+        // listeners returning void read everything
+        Value value;
+        ValueReader valueReader(value);
+        StringReader stringReader(large);
+        JsonReader jsonReader(valueReader, stringReader);
+        REQUIRE(jsonReader.Parse());
+        REQUIRE(value[EJSON_TEXT("skip")][1][EJSON_TEXT("k")].AsString() == text + EJSON_TEXT("\\\""));
+    }
+}
+
+namespace test_path
+{
+    using namespace ejson;
+
+    string ReadPaths(const string& json, std::initializer_list<string_view> paths)
+    {
+        PathFilter filter;
+        for (const string_view& path : paths)
+            REQUIRE(filter.Add(path));
+        Value value;
+        REQUIRE(Read(json, filter, value));
+        string output;
+        Write(value, output);
+        return output;
+    }
+
+    TEST_CASE("test_path")
+    {
+        const string json = EJSON_TEXT("{\"store\":{\"book\":[{\"title\":\"a\",\"price\":1},{\"title\":\"b\",\"price\":2},{\"title\":\"c\",\"tags\":[\"x\",\"y\"]}],\"bike\":{\"color\":\"red\"}},\"a/b~\":3}");
+
+        REQUIRE(ReadPaths(json, { EJSON_TEXT("/store/book/1/title") }) == EJSON_TEXT("{\"store\":{\"book\":[null,{\"title\":\"b\"}]}}"));
+        REQUIRE(ReadPaths(json, { EJSON_TEXT("$.store.book[*].title"), EJSON_TEXT("/a~1b~0") }) == EJSON_TEXT("{\"store\":{\"book\":[{\"title\":\"a\"},{\"title\":\"b\"},{\"title\":\"c\"}]},\"a/b~\":3}"));
+        REQUIRE(ReadPaths(json, { EJSON_TEXT("$.store.*.color"), EJSON_TEXT("$['store'][\"book\"][2].tags[1]") }) == EJSON_TEXT("{\"store\":{\"book\":[null,null,{\"tags\":[null,\"y\"]}],\"bike\":{\"color\":\"red\"}}}"));
+        REQUIRE(ReadPaths(json, { EJSON_TEXT("/store/bike"), EJSON_TEXT("/store/bike/color") }) == EJSON_TEXT("{\"store\":{\"bike\":{\"color\":\"red\"}}}"));
+        REQUIRE(ReadPaths(json, { EJSON_TEXT("/missing/path") }) == EJSON_TEXT("{}"));
+        REQUIRE(ReadPaths(json, {}) == EJSON_TEXT("{}"));
+        REQUIRE(ReadPaths(json, { EJSON_TEXT("$") }) == json);
+        REQUIRE(ReadPaths(EJSON_TEXT("[[1,2],[3,4]]"), { EJSON_TEXT("$[*][0]") }) == EJSON_TEXT("[[1],[3]]"));
+        REQUIRE(ReadPaths(EJSON_TEXT("12"), { EJSON_TEXT("") }) == EJSON_TEXT("12"));
+        REQUIRE(ReadPaths(EJSON_TEXT("12"), { EJSON_TEXT("/a") }) == EJSON_TEXT("null"));
+
+        // invalid paths leave the filter unchanged
+        PathFilter filter;
+        for (const string_char* path : { EJSON_TEXT("store"), EJSON_TEXT("/a~2"), EJSON_TEXT("$."), EJSON_TEXT("$[1"), EJSON_TEXT("$['a]"), EJSON_TEXT("$[x]"), EJSON_TEXT("$a") })
+            REQUIRE_FALSE(filter.Add(path));
+
+        // a filter is compiled once and read with any number of documents, errors in skipped values are found
+        REQUIRE(filter.Add(EJSON_TEXT("/id")));
+        for (int i = 0; i < 3; ++i)
+        {
+            Value value;
+            const string document = EJSON_TEXT("{\"data\":[1,{\"id\":5}],\"id\":") + string(1, (string_char)(EJSON_TEXT('0') + i)) + EJSON_TEXT("}");
+            REQUIRE(Read(document, filter, value));
+            REQUIRE(value[EJSON_TEXT("id")].AsNumber() == i);
+            REQUIRE(value.AsObject().size() == 1);
+        }
+
+        Value value;
+        ParserError error;
+        REQUIRE_FALSE(Read(EJSON_TEXT("{\"data\":[1,{\"id\":5}],\n\"id\":x}"), filter, value, error));
+        REQUIRE(error.Line == 2);
+        REQUIRE_FALSE(Read(EJSON_TEXT("{\"data\":[1,{\"id\":\"5]}"), filter, value, error));
+        REQUIRE(error.Error == EJSON_TEXT("invalid skipped value"));
+    }
+}
+
+namespace test_cursor
+{
+    using namespace ejson;
+    using test_index::LogListener;
+    using test_reader::CharByCharReader;
+    using test_reader::RandomJson;
+
+    // the cursor has no PropertyEnd
+    struct CursorLogListener : LogListener
+    {
+        void PropertyEnd() noexcept {}
+    };
+
+    template<typename READER>
+    string Walk(READER& reader, bool& result, ParserError& error)
+    {
+        string log;
+        JsonCursor cursor(reader);
+        for (bool more = true; more;)
+        {
+            switch (cursor.NextToken())
+            {
+                case CursorToken::Error:
+                case CursorToken::End:
+                    more = false;
+                    break;
+                case CursorToken::ObjectBegin: log += EJSON_TEXT("{"); break;
+                case CursorToken::ObjectEnd: log += EJSON_TEXT("}"); break;
+                case CursorToken::Key: log += EJSON_TEXT("P:"); log += cursor.CurrentKey(); break;
+                case CursorToken::ArrayBegin: log += EJSON_TEXT("["); break;
+                case CursorToken::ArrayEnd: log += EJSON_TEXT("]"); break;
+                case CursorToken::String: log += EJSON_TEXT("S:"); log += cursor.GetString(); break;
+                case CursorToken::Number: log += EJSON_TEXT("#:"); log += cursor.GetString(); break;
+                case CursorToken::True: log += EJSON_TEXT("T"); break;
+                case CursorToken::False: log += EJSON_TEXT("F"); break;
+                case CursorToken::Null: log += EJSON_TEXT("N"); break;
+            }
+        }
+        result = cursor.GetToken() == CursorToken::End;
+        error = cursor.GetError();
+        return log;
+    }
+
+    // walking every token gives the JsonReader callbacks and errors
+    void CheckSame(const string& json)
+    {
+        CursorLogListener expected;
+        StringReader stringReader(json);
+        JsonReader jsonReader(expected, stringReader);
+        const bool expectedResult = jsonReader.Parse();
+
+        bool result = false;
+        ParserError error;
+        StringReader cursorReader(json);
+        REQUIRE(Walk(cursorReader, result, error) == expected.log);
+        REQUIRE(result == expectedResult);
+        REQUIRE(error.Error == jsonReader.GetError().Error);
+        REQUIRE(error.Line == jsonReader.GetError().Line);
+        REQUIRE(error.Column == jsonReader.GetError().Column);
+
+        CharByCharReader charReader{ json };
+        REQUIRE(Walk(charReader, result, error) == expected.log);
+        REQUIRE(result == expectedResult);
+        REQUIRE(error.Line == jsonReader.GetError().Line);
+        REQUIRE(error.Column == jsonReader.GetError().Column);
+    }
+
+    struct Person
+    {
+        string Name;
+        number Age = 0;
+        vector<string> Music;
+    };
+
+    // straight-line deserializer, unknown properties are skipped
+    bool ReadPerson(const string& json, Person& person, ParserError& error)
+    {
+        StringReader stringReader(json);
+        JsonCursor cursor(stringReader);
+        if (!cursor.EnterObject())
+        {
+            error = cursor.GetError();
+            return false;
+        }
+        while (cursor.NextToken() == CursorToken::Key)
+        {
+            if (cursor.CurrentKey() == EJSON_TEXT("name") && cursor.NextToken() == CursorToken::String)
+            {
+                person.Name = cursor.GetString();
+            }
+            else if (cursor.CurrentKey() == EJSON_TEXT("age") && cursor.NextToken() == CursorToken::Number)
+            {
+                person.Age = cursor.GetNumber();
+            }
+            else if (cursor.CurrentKey() == EJSON_TEXT("music") && cursor.EnterArray())
+            {
+                while (cursor.NextToken() == CursorToken::String)
+                    person.Music.push_back(string(cursor.GetString()));
+                // the first other value ends the list
+                if (cursor.GetToken() != CursorToken::ArrayEnd && cursor.SkipValue())
+                    cursor.LeaveArray();
+            }
+            else
+            {
+                cursor.SkipValue();
+            }
+        }
+        const bool result = cursor.GetToken() == CursorToken::ObjectEnd && cursor.NextToken() == CursorToken::End;
+        error = cursor.GetError();
+        return result;
+    }
+
+    TEST_CASE("test_cursor")
+    {
+        for (const string& json : {
+            string(EJSON_TEXT("{\"name\":\"John\",\"age\":42,\"music\":[\"punk\",true,false,null,-1.5],\"a\\\\\\\"b\\u1234\":[[],[1 2,]]}")),
+            string(EJSON_TEXT("[1-2,truefalse, 3.4.5]")),
+            string(EJSON_TEXT("\"line\r\nending\"\r\n")),
+            string(EJSON_TEXT("12")),
+            string(EJSON_TEXT("")),
+            string(EJSON_TEXT("[1,")),
+            string(EJSON_TEXT("[1,,2]")),
+            string(EJSON_TEXT("{\"a\" 1}")),
+            string(EJSON_TEXT("{\"a\":1 \"b\":2}")),
+            string(EJSON_TEXT("{}")),
+            string(EJSON_TEXT("[nul]")),
+            string(EJSON_TEXT("[\"abc")),
+            string(EJSON_TEXT("[1]\n  x")),
+            string(EJSON_TEXT("[\r 1]")) })
+        {
+            CheckSame(json);
+        }
+
+        Person person;
+        ParserError error;
+        REQUIRE(ReadPerson(EJSON_TEXT("{\"id\":{\"x\":[1,{}]},\"name\":\"John\",\"music\":[\"punk\",\"folk\",{\"skipped\":1},\"jazz\"],\"age\":71,\"tail\":[]}"), person, error));
+        REQUIRE(person.Name == EJSON_TEXT("John"));
+        REQUIRE(person.Age == 71);
+        REQUIRE(person.Music == vector<string>{ EJSON_TEXT("punk"), EJSON_TEXT("folk") });
+
+        REQUIRE_FALSE(ReadPerson(EJSON_TEXT("[1]"), person, error));
+        REQUIRE(error.Error == EJSON_TEXT("expected object"));
+        REQUIRE_FALSE(ReadPerson(EJSON_TEXT("{\"name\":\"John\",\n\"skip\":{\"a\":[}"), person, error));
+        REQUIRE(error.Error == EJSON_TEXT("invalid skipped value"));
+        REQUIRE(error.Line == 2);
+        REQUIRE_FALSE(ReadPerson(EJSON_TEXT("{\"name\":\"John\"} x"), person, error));
+        REQUIRE(error.Error == EJSON_TEXT("invalid input after value"));
+
+        // leaving an object skips what is left of it
+        StringReader stringReader(EJSON_TEXT("[{\"a\":1,\"b\":{\"c\":\"}\"},\"d\":2},3]"));
+        JsonCursor cursor(stringReader);
+        REQUIRE(cursor.EnterArray());
+        REQUIRE(cursor.EnterObject());
+        REQUIRE(cursor.NextToken() == CursorToken::Key);
+        REQUIRE(cursor.NextToken() == CursorToken::Number);
+        REQUIRE(cursor.GetNumber() == 1);
+        REQUIRE(cursor.LeaveObject());
+        REQUIRE(cursor.GetToken() == CursorToken::ObjectEnd);
+        REQUIRE(cursor.NextToken() == CursorToken::Number);
+        REQUIRE(cursor.NextToken() == CursorToken::ArrayEnd);
+        REQUIRE(cursor.NextToken() == CursorToken::End);
+        REQUIRE_FALSE(cursor.HaveError());
+    }
+
+    // random documents, half of them broken, walked token by token
+    TEST_CASE("test_cursor_random")
+    {
+        RandomJson random{ 0x5851F42D4C957F2Dull };
+        for (int test = 0; test < 3000; ++test)
+            CheckSame(random.Document());
+    }
+}
+
+namespace test_number_token
+{
+    using namespace ejson;
+    using test_index::LogListener;
+    using test_reader::CharByCharReader;
+
+    // takes converted numbers, keeps the text callback of LogListener unused
+    struct NumberListener : LogListener
+    {
+        std::vector<number> values;
+
+        void ValueNumber(const NumberToken& token) noexcept
+        {
+            log += EJSON_TEXT("#:");
+            log += token.Text;
+            values.push_back(token.Value);
+        }
+    };
+
+    // every engine gives the same tokens, values and errors as text parsed by ParseNumber
+    std::vector<number> CheckNumbers(const string& json, const string& error = string())
+    {
+        LogListener expected;
+        StringReader expectedStringReader(json);
+        JsonReader expectedReader(expected, expectedStringReader);
+        REQUIRE(expectedReader.Parse() == error.empty());
+        REQUIRE(expectedReader.GetError().Error == error);
+
+        NumberListener listener;
+        StringReader stringReader(json);
+        JsonReader jsonReader(listener, stringReader);
+        REQUIRE(jsonReader.Parse() == error.empty());
+        REQUIRE(listener.log == expected.log);
+        REQUIRE(jsonReader.GetError().Error == error);
+        REQUIRE(jsonReader.GetError().Line == expectedReader.GetError().Line);
+        REQUIRE(jsonReader.GetError().Column == expectedReader.GetError().Column);
+
+        auto checkSame = [&](bool result, const ParserError& parserError, const NumberListener& other)
+        {
+            REQUIRE(result == error.empty());
+            REQUIRE(other.log == listener.log);
+            REQUIRE(other.values == listener.values);
+            REQUIRE(parserError.Error == error);
+            REQUIRE(parserError.Line == expectedReader.GetError().Line);
+            REQUIRE(parserError.Column == expectedReader.GetError().Column);
+        };
+
+        {
+            NumberListener other;
+            CharByCharReader charReader{ json };
+            JsonReader<NumberListener, CharByCharReader> charJsonReader(other, charReader);
+            const bool result = charJsonReader.Parse();
+            checkSame(result, charJsonReader.GetError(), other);
+        }
+        {
+            NumberListener other;
+            JsonIndexReader indexReader(other, json);
+            const bool result = indexReader.Parse();
+            checkSame(result, indexReader.GetError(), other);
+        }
+        {
+            NumberListener other;
+            JsonPushReader pushReader(other);
+            for (size_t i = 0; i < json.size(); ++i)
+                pushReader.Feed(string_view(json.data() + i, 1));
+            const bool result = pushReader.Finish() == PushStatus::Done;
+            checkSame(result, pushReader.GetError(), other);
+        }
+        return listener.values;
+    }
+
+    TEST_CASE("test_number_token")
+    {
+        static_assert(ListensNumberTokens<NumberListener>);
+        static_assert(!ListensNumberTokens<LogListener>);
+        static_assert(ListensNumberTokens<ValueReader> == !EJSON_LAZY_NUMBERS);
+
+        CHECK(CheckNumbers(EJSON_TEXT("12")) == std::vector<number>{ 12 });
+        CHECK(CheckNumbers(EJSON_TEXT("[0.1,-40.74844205, 3.141592653589793238462643383279 ,0,-0]")) == std::vector<number>{ 0.1, -40.74844205, 3.141592653589793238462643383279, 0.0, -0.0 });
+        CHECK(CheckNumbers(EJSON_TEXT("{\"id\":9007199254740993,\"a\":[1 2 3,]}")) == std::vector<number>{ 9007199254740992.0, 1, 2, 3 });
+
+        // glued to the next token
+        CHECK(CheckNumbers(EJSON_TEXT("[1\"a\"2null]")) == std::vector<number>{ 1, 2 });
+
+        // numbers the tokenizer accepts and ParseNumber does not convert entirely
+        CheckNumbers(EJSON_TEXT("[1.2.3]"));
+        CheckNumbers(EJSON_TEXT("[1..2]"));
+
+        // errors
+        CheckNumbers(EJSON_TEXT("[1.]"), EJSON_TEXT("invalid number"));
+        CheckNumbers(EJSON_TEXT("[-.5]"), EJSON_TEXT("invalid number"));
+        CheckNumbers(EJSON_TEXT("[.5]"), EJSON_TEXT("invalid token"));
+        CheckNumbers(EJSON_TEXT("[1e5]"), EJSON_TEXT("invalid token"));
+        CheckNumbers(EJSON_TEXT("-"), EJSON_TEXT("invalid number"));
+
+        // the cursor hands out the converted value
+        {
+            StringReader stringReader(EJSON_TEXT("[0.3,-73.98565432]"));
+            JsonCursor cursor(stringReader);
+            REQUIRE(cursor.EnterArray());
+            REQUIRE(cursor.NextToken() == CursorToken::Number);
+            CHECK(cursor.GetNumber() == 0.3);
+            REQUIRE(cursor.NextToken() == CursorToken::Number);
+            CHECK(cursor.GetNumber() == -73.98565432);
+        }
+    }
+}
+
+namespace test_int64
+{
+    using namespace ejson;
+
+    TEST_CASE("test_int64")
+    {
+        // the tokenizer keeps integers exact
+        {
+            NumberToken token;
+            REQUIRE(ParseNumber(EJSON_TEXT("9007199254740993"), token));
+            CHECK(token.Type == NumberType::Int64);
+            CHECK(token.Int64 == 9007199254740993ll);
+            CHECK(token.Value == 9007199254740992.0);
+
+            REQUIRE(ParseNumber(EJSON_TEXT("-9223372036854775808"), token));
+            CHECK(token.Type == NumberType::Int64);
+            CHECK(token.Int64 == std::numeric_limits<s64>::min());
+
+            REQUIRE(ParseNumber(EJSON_TEXT("9223372036854775808"), token));
+            CHECK(token.Type == NumberType::UInt64);
+            CHECK(token.UInt64 == 9223372036854775808ull);
+
+            REQUIRE(ParseNumber(EJSON_TEXT("18446744073709551615"), token));
+            CHECK(token.Type == NumberType::UInt64);
+            CHECK(token.UInt64 == std::numeric_limits<u64>::max());
+
+            REQUIRE(ParseNumber(EJSON_TEXT("00000000000000000000042"), token));
+            CHECK(token.Type == NumberType::Int64);
+            CHECK(token.Int64 == 42);
+
+            // out of range, fraction, exponent and negative zero stay floating point
+            for (const string_char* text : { EJSON_TEXT("18446744073709551616"), EJSON_TEXT("-9223372036854775809"), EJSON_TEXT("1.0"), EJSON_TEXT("1e2"), EJSON_TEXT("-0") })
+            {
+                REQUIRE(ParseNumber(text, token));
+                CHECK(token.Type == NumberType::Float);
+            }
+        }
+
+        // read and written back unchanged
+        {
+            const string json = EJSON_TEXT("[1234567890123456789,-9223372036854775808,18446744073709551615,0,-7,12345678]");
+            Value value;
+            REQUIRE(Read(json, value));
+            CHECK(value[0].GetNumberType() == (EJSON_LAZY_NUMBERS ? NumberType::Text : NumberType::Int64));
+            CHECK(value[0].AsInt64() == 1234567890123456789ll);
+            CHECK(value[1].AsInt64() == std::numeric_limits<s64>::min());
+            CHECK(value[2].GetNumberType() == (EJSON_LAZY_NUMBERS ? NumberType::Text : NumberType::UInt64));
+            CHECK(value[2].AsUInt64() == std::numeric_limits<u64>::max());
+            CHECK(value[4].AsInt64() == -7);
+            CHECK(value[4].GetNumber() == -7.0);
+            CHECK(value[4].GetNumberType() == (EJSON_LAZY_NUMBERS ? NumberType::Text : NumberType::Int64));
+
+            string output;
+            Write(value, output);
+            CHECK(output == json);
+
+            // copies keep the integer
+            const Value copy = value;
+            CHECK(copy[0].GetNumberType() == (EJSON_LAZY_NUMBERS ? NumberType::Text : NumberType::Int64));
+            CHECK(copy[0].AsInt64() == 1234567890123456789ll);
+        }
+
+        // AsNumber still reads and writes a number, GetNumber reads it without conversion
+        {
+            Value value = (s64)9007199254740993ll;
+            CHECK(value.IsNumber());
+            const Value& constValue = value;
+            const number& read = constValue.AsNumber();
+            CHECK(read == 9007199254740992.0);
+            CHECK(constValue.GetNumberType() == NumberType::Int64);
+            CHECK(value.GetNumber() == 9007199254740992.0);
+            CHECK(value.GetNumberType() == NumberType::Int64);
+            CHECK(value.AsInt64() == 9007199254740993ll);
+
+            value.AsNumber() += 0.5;
+            CHECK(value.GetNumberType() == NumberType::Float);
+            CHECK(value.AsNumber() == 9007199254740992.5);
+            CHECK(value.AsInt64() == 9007199254740992ll);
+        }
+
+        // floating point numbers out of the integer range are saturated
+        {
+            const number infinity = std::numeric_limits<number>::infinity();
+            CHECK(Value(1e20).AsInt64() == std::numeric_limits<s64>::max());
+            CHECK(Value(-1e20).AsInt64() == std::numeric_limits<s64>::min());
+            CHECK(Value(1e20).AsUInt64() == std::numeric_limits<u64>::max());
+            CHECK(Value(-2.5).AsUInt64() == 0);
+            CHECK(Value(-2.5).AsInt64() == -2);
+            CHECK(Value(infinity).AsInt64() == std::numeric_limits<s64>::max());
+            CHECK(Value(-infinity).AsUInt64() == 0);
+            CHECK(Value(std::numeric_limits<number>::quiet_NaN()).AsInt64() == 0);
+            CHECK(Value(std::numeric_limits<number>::quiet_NaN()).AsUInt64() == 0);
+        }
+
+        // integers from code
+        {
+            Value json;
+            json[EJSON_TEXT("Age")] = 71;
+            json[EJSON_TEXT("Id")] = std::numeric_limits<u64>::max();
+            json[EJSON_TEXT("Ratio")] = 0.5;
+            CHECK(json[EJSON_TEXT("Age")].GetNumberType() == NumberType::Int64);
+            CHECK(json[EJSON_TEXT("Id")].GetNumberType() == NumberType::UInt64);
+
+            string output;
+            Write(json, output);
+            CHECK(output.find(EJSON_TEXT("\"Id\":18446744073709551615")) != string::npos);
+            CHECK(output.find(EJSON_TEXT("\"Age\":71")) != string::npos);
+        }
+    }
+}
+
+namespace test_lazy_number
+{
+    using namespace ejson;
+
+    TEST_CASE("test_lazy_number")
+    {
+        // converted on access, written back as is
+        {
+            Value value;
+            value.SetNumberText(EJSON_TEXT("1.50"));
+            CHECK(value.IsNumber());
+            CHECK(value.GetNumberType() == NumberType::Text);
+            CHECK(value.GetNumberText() == "1.50");
+            CHECK(((const Value&)value).AsNumber() == 1.5);
+            CHECK(value.AsInt64() == 1);
+
+            // a read keeps the text
+            CHECK(value.GetNumber() == 1.5);
+            CHECK(value.GetNumberType() == NumberType::Text);
+
+            string output;
+            Write(value, output);
+            CHECK(output == EJSON_TEXT("1.50"));
+
+            const Value copy = value;
+            CHECK(copy.GetNumberText() == "1.50");
+
+            // writable access makes it a floating point number
+            value.AsNumber() *= 2;
+            CHECK(value.GetNumberType() == NumberType::Float);
+            CHECK(value.AsNumber() == 3.0);
+        }
+        {
+            Value value;
+            value.SetNumberText(EJSON_TEXT("18446744073709551615"));
+            CHECK(value.AsUInt64() == std::numeric_limits<u64>::max());
+            value.SetNumberText(EJSON_TEXT("-1E+02"));
+            CHECK(value.AsInt64() == -100);
+        }
+
+        // too long for the value storage: kept apart
+        {
+            string text = EJSON_TEXT("0.");
+            for (int i = 0; i < 100; ++i)
+                text += EJSON_TEXT("3");
+            Value value;
+            value.SetNumberText(text);
+            CHECK(value.GetNumberType() == NumberType::Text);
+            CHECK(value.GetNumber() == 0.3333333333333333);
+            Value copy = value;
+            Value moved(EJSON_MOVE(value));
+            CHECK(copy.GetNumberText() == moved.GetNumberText());
+            CHECK(StringSize(moved.GetNumberText()) == 102);
+
+            string output;
+            Write(moved, output);
+            CHECK(output == text);
+
+            copy.SetNumberText(EJSON_TEXT("1"));
+            CHECK(copy.AsInt64() == 1);
+            moved.AsNumber() += 1;
+            CHECK(moved.GetNumberType() == NumberType::Float);
+            CHECK(moved.GetNumber() == 1.3333333333333333);
+        }
+
+#if EJSON_LAZY_NUMBERS
+        // every number read is kept as written
+        {
+            const string json = EJSON_TEXT("{\"a\":[1.50,-0.000,12345678901234567890123,7],\"b\":0.1}");
+            Value value;
+            REQUIRE(Read(json, value));
+            CHECK(value[EJSON_TEXT("a")][0].GetNumberType() == NumberType::Text);
+            CHECK(value[EJSON_TEXT("b")].GetNumber() == 0.1);
+
+            string output;
+            Write(value, output);
+            CHECK(output == json);
+        }
+
+        // longer than the value storage
+        {
+            const string json = EJSON_TEXT("[123456789012345678901234567890123456789012345678901234567890]");
+            Value value;
+            REQUIRE(Read(json, value));
+            CHECK(value[0].GetNumberType() == NumberType::Text);
+
+            string output;
+            Write(value, output);
+            CHECK(output == json);
+        }
+#endif
+    }
+}
+
+namespace test_format_number
+{
+    using namespace ejson;
+
+    string Format(number value)
+    {
+        string_char text[FormatNumberSize];
+        return string(text, FormatNumber(value, text));
+    }
+
+    TEST_CASE("test_format_number")
+    {
+        CHECK(Format(0.0) == EJSON_TEXT("0"));
+        CHECK(Format(-0.0) == EJSON_TEXT("-0"));
+        CHECK(Format(71) == EJSON_TEXT("71"));
+        CHECK(Format(-1234567.0) == EJSON_TEXT("-1234567"));
+        CHECK(Format(0.1) == EJSON_TEXT("0.1"));
+        CHECK(Format(1e22) == EJSON_TEXT("1e+22"));
+        if constexpr (std::is_same_v<number, double>)
+        {
+            CHECK(Format(9007199254740991.0) == EJSON_TEXT("9007199254740991"));
+            CHECK(Format(-40.74844205) == EJSON_TEXT("-40.74844205"));
+            CHECK(Format(0.30000000000000004) == EJSON_TEXT("0.30000000000000004"));
+            CHECK(Format(5e-324) == EJSON_TEXT("5e-324"));
+            CHECK(Format(-2.2250738585072014e-308) == EJSON_TEXT("-2.2250738585072014e-308"));
+            CHECK(Format(1.7976931348623157e308) == EJSON_TEXT("1.7976931348623157e+308"));
+        }
+
+        // reads back to the same bits
+        u64 seed = 0x9E3779B97F4A7C15ull;
+        for (int i = 0; i < 100000; ++i)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            u64 bits = seed;
+            if (i % 2 == 0)
+                bits = (bits & 0x800FFFFFFFFFFFFFull) | ((u64)(1023 - 40 + (seed >> 52) % 80) << 52);
+            double bitsValue = 0.0;
+            std::memcpy(&bitsValue, &bits, sizeof(bitsValue));
+            const number value = (number)bitsValue;
+            if (!std::isfinite(value))
+                continue;
+            const string text = Format(value);
+            number result = 1;
+            REQUIRE(ParseNumber(text, result));
+            REQUIRE(std::memcmp(&result, &value, sizeof(number)) == 0);
+        }
+
+        // written by JsonWriter
+        Value value;
+        value[0] = 0.1;
+        value[1] = 123456.25;
+        value[2] = 1e-7;
+        string output;
+        Write(value, output);
+        CHECK(output == EJSON_TEXT("[0.1,123456.25,1e-07]"));
+    }
+}
+
+namespace test_buffered_writer
+{
+    using namespace ejson;
+
+    TEST_CASE("test_buffered_writer")
+    {
+        Value value;
+        REQUIRE(Read(EJSON_TEXT("{\"name\":\"John\",\"tags\":[true,null,12],\"text\":\"a long text going straight to the sink\"}"), value));
+        string expected;
+        Write(value, expected);
+
+        // small flush size, output comes in blocks
+        vector<string> blocks;
+        {
+            BufferedWriter writer([&](const string_view& str) { VectorEmplace(blocks, string(str)); return true; }, 16);
+            JsonWriter jsonWriter(writer);
+            ValueWriter valueWriter(jsonWriter);
+            valueWriter.Write(value);
+            CHECK(writer.Flush());
+            CHECK(writer.Flush());
+        }
+        string output;
+        for (const string& block : blocks)
+            output += block;
+        CHECK(output == expected);
+        CHECK(VectorSize(blocks) > 3);
+        bool direct = false;
+        for (size_t i = 0; i + 1 < VectorSize(blocks); ++i)
+        {
+            CHECK(StringSize(blocks[i]) <= 38);
+            direct = direct || StringSize(blocks[i]) > 16;
+        }
+        CHECK(direct);
+
+        // nothing written before the flush size or Flush()
+        size_t calls = 0;
+        {
+            BufferedWriter writer([&](const string_view&) { ++calls; return true; });
+            writer.Write(EJSON_TEXT('['));
+            writer.Write(string_view(EJSON_TEXT("1,2")));
+            writer.Write(c_string_view("3"));
+            writer.Write(w_string_view(L"]"));
+            CHECK(calls == 0);
+        }
+        CHECK(calls == 1);
+
+        // sink failure is reported by Flush, later output is dropped
+        calls = 0;
+        BufferedWriter failing([&](const string_view&) { ++calls; return false; }, 4);
+        failing.Write(string_view(EJSON_TEXT("[1,2,3]")));
+        CHECK(failing.Write(EJSON_TEXT(',')) == false);
+        CHECK(failing.Write(string_view(EJSON_TEXT("[4,5,6]"))) == 0);
+        CHECK(!failing.Flush());
+        CHECK(calls == 1);
+
+        // stream
+        std::basic_ostringstream<string_char> stream;
+        {
+            StreamWriter writer(stream);
+            JsonWriter jsonWriter(writer);
+            ValueWriter valueWriter(jsonWriter);
+            valueWriter.Write(value);
+            CHECK(stream.str().empty());
+            CHECK(writer.Flush());
+            CHECK(string_view(stream.str()) == expected);
+        }
+        CHECK(string_view(stream.str()) == expected);
+
+        std::basic_ostringstream<string_char> prettifyStream;
+        Write(value, prettifyStream, true);
+        string prettify;
+        Write(value, prettify, true);
+        CHECK(string_view(prettifyStream.str()) == prettify);
+    }
+}
+
+#if EJSON_ARENA
+namespace test_document
+{
+    using namespace ejson;
+
+    struct CountingResource : std::pmr::memory_resource
+    {
+        size_t Allocations = 0;
+        size_t Deallocations = 0;
+
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            ++Allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override
+        {
+            ++Deallocations;
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    TEST_CASE("test_document")
+    {
+        // the name is longer than the inline storage of a value in every layout, it is a string
+        const string json = EJSON_TEXT("{\"name\":\"a name longer than the small string buffer and than the inline storage of a value, in every layout\",\"tags\":[\"another long string value here\",12,true,null],\"nested\":{\"a\":[[],{\"b\":false}]}}");
+
+        // everything read under a scope comes from its resource
+        {
+            CountingResource resource;
+            {
+                ArenaScope scope(resource);
+                Value value;
+                REQUIRE(Read(json, value));
+                CHECK(resource.Allocations > 5);
+                CHECK(value.AsObject().size() == 3);
+                CHECK(value[EJSON_TEXT("name")].AsString().get_allocator().resource() == &resource);
+                CHECK(value[EJSON_TEXT("tags")].AsArray().get_allocator().resource() == &resource);
+                CHECK(value[EJSON_TEXT("nested")][EJSON_TEXT("a")].AsArray().get_allocator().resource() == &resource);
+            }
+            CHECK(resource.Allocations == resource.Deallocations);
+            CHECK(ThreadResource() == std::pmr::new_delete_resource());
+        }
+
+        Document document(256);
+        REQUIRE(document.Read(json));
+        string output;
+        Write(document.GetRoot(), output);
+        CHECK(output == json);
+        CHECK(document.GetRoot()[EJSON_TEXT("name")].AsString().get_allocator().resource() == &document.GetArena());
+        CHECK(document.GetRoot()[EJSON_TEXT("tags")].AsArray().get_allocator().resource() == &document.GetArena());
+        CHECK(document.GetArena().Size() > 0);
+        const size_t capacity = document.GetArena().Capacity();
+        CHECK(capacity >= document.GetArena().Size());
+
+        // a copy allocates from the heap and outlives the document tree
+        Value copy = document.GetRoot();
+        CHECK(copy[EJSON_TEXT("tags")].AsArray().get_allocator().resource() == std::pmr::new_delete_resource());
+
+        // values added outside a scope come from the heap
+        document.GetRoot()[EJSON_TEXT("added")][2] = EJSON_TEXT("added after the read");
+        CHECK(document.GetRoot()[EJSON_TEXT("added")].AsArray().get_allocator().resource() == std::pmr::new_delete_resource());
+
+        // reset keeps the chunks, the same document fits again
+        document.Reset();
+        CHECK(document.GetRoot().IsInvalid());
+        CHECK(document.GetArena().Size() == 0);
+        for (int i = 0; i < 10; ++i)
+        {
+            REQUIRE(document.Read(json));
+            CHECK(document.GetArena().Capacity() == capacity);
+        }
+
+        // the reader's own buffers come from the resource of the caller, released with the read
+        {
+            CountingResource resource;
+            {
+                ArenaScope scope(resource);
+                REQUIRE(document.Read(json));
+            }
+            CHECK(resource.Allocations > 0);
+            CHECK(resource.Allocations == resource.Deallocations);
+            CHECK(document.GetRoot()[EJSON_TEXT("tags")].AsArray().get_allocator().resource() == &document.GetArena());
+        }
+        string copyOutput;
+        Write(copy, copyOutput);
+        CHECK(copyOutput == json);
+
+        // errors
+        ParserError error;
+        CHECK_FALSE(document.Read(EJSON_TEXT("{\"name\":}"), error));
+        CHECK(document.GetRoot().IsInvalid());
+        CHECK(StringSize(error.Error) > 0);
+
+        // alignment and allocations larger than a chunk
+        Arena arena(64);
+        for (size_t alignment = 1; alignment <= 64; alignment *= 2)
+        {
+            void* pointer = arena.allocate(3, alignment);
+            CHECK((std::uintptr_t)pointer % alignment == 0);
+        }
+        char* large = (char*)arena.allocate(1000, 16);
+        std::memset(large, 1, 1000);
+        CHECK(arena.Size() == 7 * 3 + 1000);
+        arena.Reset();
+        CHECK(arena.Size() == 0);
+    }
+}
+#endif
+
+namespace test_inline_string
+{
+    using namespace ejson;
+
+    bool IsInline(const Value& value)
+    {
+        const char* data = (const char*)value.AsStringView().data();
+        return data >= (const char*)&value && data < (const char*)(&value + 1);
+    }
+
+    TEST_CASE("test_inline_string")
+    {
+        // every length around the inline capacity, through copy, move and write
+        string text;
+        bool inlined = false;
+        bool heap = false;
+        for (int size = 0; size < 300; ++size)
+        {
+            Value value(text);
+            CHECK(value.AsStringView() == text);
+            inlined = inlined || IsInline(value);
+            heap = heap || !IsInline(value);
+            if (size <= (EJSON_VALUE_COMPACT ? 13 / (int)sizeof(string_char) : 12))
+                CHECK(IsInline(value));
+
+            Value copy = value;
+            CHECK(copy.AsStringView() == text);
+            Value moved(EJSON_MOVE(copy));
+            CHECK(moved.AsStringView() == text);
+            CHECK(copy.IsInvalid());
+
+            string output;
+            Write(moved, output);
+            CHECK(output == EJSON_TEXT("\"") + text + EJSON_TEXT("\""));
+
+            Value array;
+            array[0] = value;
+            array[1] = EJSON_MOVE(moved);
+            Value arrayCopy = array;
+            CHECK(arrayCopy[0].AsStringView() == text);
+            CHECK(arrayCopy[1].AsStringView() == text);
+
+            text += (string_char)(EJSON_TEXT('a') + size % 26);
+        }
+        CHECK(inlined);
+        CHECK(heap);
+
+        // short strings read from json are inline
+        Value value;
+        REQUIRE(Read(EJSON_TEXT("[\"ok\",\"GET\",\"CA\",\"\"]"), value));
+        for (size_t i = 0; i < 4; ++i)
+            CHECK(IsInline(value[i]));
+        string output;
+        Write(value, output);
+        CHECK(output == EJSON_TEXT("[\"ok\",\"GET\",\"CA\",\"\"]"));
+
+        // AsString gives a string that may be modified
+        Value status(EJSON_TEXT("ok"));
+        CHECK(IsInline(status));
+        status.AsString() += EJSON_TEXT(" then a longer text that does not fit inline");
+        CHECK(!IsInline(status));
+        CHECK(status.AsStringView() == EJSON_TEXT("ok then a longer text that does not fit inline"));
+        const Value& constStatus = status;
+        CHECK(constStatus.AsString() == EJSON_TEXT("ok then a longer text that does not fit inline"));
+
+        // a const value gives a copy and stays inline
+        const Value constCode(EJSON_TEXT("ok"));
+        const string& constText = constCode.AsString();
+        CHECK(constText == EJSON_TEXT("ok"));
+        CHECK(IsInline(constCode));
+
+        // from its own characters
+        Value code(EJSON_TEXT("GET"));
+        code.SetString(code.AsStringView().substr(1));
+        CHECK(code.AsStringView() == EJSON_TEXT("ET"));
+        code = EJSON_TEXT("x");
+        CHECK(code.AsStringView() == EJSON_TEXT("x"));
+        code = string(EJSON_TEXT("y"));
+        CHECK(code.AsString() == EJSON_TEXT("y"));
+        code = nullptr;
+        CHECK(code.IsNull());
+
+        // from its own heap string, to inline or moved
+        Value heapText(string(EJSON_TEXT("a long string stored on the heap ")) + string(100, EJSON_TEXT('x')));
+        CHECK(!IsInline(heapText));
+        heapText.SetString(heapText.AsStringView().substr(2, 3));
+        CHECK(IsInline(heapText));
+        CHECK(heapText.AsStringView() == EJSON_TEXT("lon"));
+        heapText = string(100, EJSON_TEXT('y'));
+        heapText.SetString(EJSON_MOVE(heapText.AsString()));
+        CHECK(heapText.AsStringView() == string(100, EJSON_TEXT('y')));
+    }
+}
+
+namespace test_shared_keys
+{
+    using namespace ejson;
+
+    const string* KeyAddress(const Value& object, size_t index)
+    {
+        size_t i = 0;
+        for (const auto& [key, value] : object.AsObject())
+        {
+            if (i++ == index)
+                return &key;
+        }
+        return nullptr;
+    }
+
+    TEST_CASE("test_shared_keys")
+    {
+        string json = EJSON_TEXT("[");
+        for (int i = 0; i < 100; ++i)
+            json += string(i == 0 ? EJSON_TEXT("") : EJSON_TEXT(",")) + EJSON_TEXT("{\"identifier\":1,\"a property name\":2,\"x\":3}");
+        json += EJSON_TEXT("]");
+
+        Value value;
+        REQUIRE(Read(json, value));
+        for (size_t i = 0; i < 100; ++i)
+        {
+            const Value& record = value[i];
+            REQUIRE(record.AsObject().size() == 3);
+            CHECK(record[EJSON_TEXT("identifier")].AsInt64() == 1);
+            CHECK(record[EJSON_TEXT("a property name")].AsInt64() == 2);
+            CHECK(*KeyAddress(record, 2) == EJSON_TEXT("x"));
+#if EJSON_MAP_ORDERED
+            // one key for all records
+            CHECK(KeyAddress(record, 0) == KeyAddress(value[0], 0));
+            CHECK(KeyAddress(record, 1) == KeyAddress(value[0], 1));
+#endif
+        }
+
+        // copies share the keys, changes stay in the copy
+        Value copy = value[5];
+#if EJSON_MAP_ORDERED
+        CHECK(KeyAddress(copy, 1) == KeyAddress(value[0], 1));
+#endif
+        copy[EJSON_TEXT("added")] = true;
+        CHECK(copy.AsObject().size() == 4);
+        CHECK(value[5].AsObject().size() == 3);
+        string output;
+        Write(copy, output);
+        CHECK(output == EJSON_TEXT("{\"identifier\":1,\"a property name\":2,\"x\":3,\"added\":true}"));
+        value = Value();
+        CHECK(copy[EJSON_TEXT("a property name")].AsInt64() == 2);
+
+        // copies and releases from many threads
+        Value shared;
+        REQUIRE(Read(json, shared));
+        vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&]
+            {
+                for (int i = 0; i < 200; ++i)
+                {
+                    Value local = ((const Value&)shared)[(size_t)i % 100];
+                    CHECK(local[EJSON_TEXT("x")].AsInt64() == 3);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+
+        // last value of a duplicated key is kept
+        REQUIRE(Read(EJSON_TEXT("{\"a\":1,\"b\":2,\"a\":3}"), value));
+        CHECK(value.AsObject().size() == 2);
+        CHECK(value[EJSON_TEXT("a")].AsInt64() == 3);
+
+        // more names than the table keeps
+        json = EJSON_TEXT("{");
+        for (int i = 0; i < 5000; ++i)
+            json += string(i == 0 ? EJSON_TEXT("") : EJSON_TEXT(",")) + EJSON_TEXT("\"key") + string(EJSON_TEXT("0123456789")).substr(i % 10, 1) + string(1, (string_char)(EJSON_TEXT('a') + i / 10 % 26)) + string(1, (string_char)(EJSON_TEXT('a') + i / 260)) + EJSON_TEXT("\":") + string(1, (string_char)(EJSON_TEXT('0') + i % 10));
+        json += EJSON_TEXT("}");
+        REQUIRE(Read(json, value));
+        CHECK(value.AsObject().size() == 5000);
+        CHECK(value[EJSON_TEXT("key7ca")].AsInt64() == 7);
+        CHECK(value[EJSON_TEXT("key9zs")].AsInt64() == 9);
+        output.clear();
+        Write(value, output);
+        CHECK(output == json);
+
+        // records of a file share their keys
+        vector<Value> records;
+        LinesOptions options;
+        options.Workers = 1;
+        ReadLines(EJSON_TEXT("{\"level\":\"info\"}\n{\"level\":\"warning\"}\n"), [&](size_t, bool result, Value& record, const ParserError&)
+        {
+            CHECK(result);
+            records.push_back(EJSON_MOVE(record));
+        }, options);
+        REQUIRE(records.size() == 2);
+        CHECK(records[1][EJSON_TEXT("level")].AsStringView() == EJSON_TEXT("warning"));
+#if EJSON_MAP_ORDERED
+        CHECK(KeyAddress(records[0], 0) == KeyAddress(records[1], 0));
+#endif
+    }
+}
+
+#if EJSON_MAP_ORDERED
+namespace test_ordered_map
+{
+    using namespace ejson;
+
+    string Key(int i)
+    {
+        std::string digits = std::to_string(i * 7919 % 100003);
+        return EJSON_TEXT("k") + string(digits.begin(), digits.end());
+    }
+
+    TEST_CASE("test_ordered_map")
+    {
+        map<string, Value> object;
+        CHECK(object.size() == 0);
+        CHECK(object.Find(Key(0)) == nullptr);
+
+        for (int i = 0; i < 1000; ++i)
+            object[Key(i)] = i;
+        REQUIRE(object.size() == 1000);
+
+        // insertion order, entries are contiguous
+        int i = 0;
+        const Value* previous = nullptr;
+        for (const auto& [key, value] : object)
+        {
+            CHECK(key == Key(i));
+            CHECK(value.AsInt64() == i);
+            if (previous != nullptr)
+                CHECK((const char*)&value - (const char*)previous == sizeof(map<string, Value>::Entry));
+            previous = &value;
+            ++i;
+        }
+        CHECK(i == 1000);
+
+        for (i = 0; i < 1000; ++i)
+        {
+            REQUIRE(object.Find(Key(i)) != nullptr);
+            CHECK(object.Find(Key(i))->AsInt64() == i);
+        }
+        CHECK(object.Find(EJSON_TEXT("k")) == nullptr);
+        CHECK(object.Find(Key(1000)) == nullptr);
+
+        // existing keys are kept
+        auto [existing, added] = object.emplace(Key(3), Value(-1));
+        CHECK(!added);
+        CHECK(existing->AsInt64() == 3);
+        CHECK(object.TryEmplace(Key(4), Value(-1))->AsInt64() == 4);
+        CHECK(object.size() == 1000);
+        CHECK(object.emplace(EJSON_TEXT("new"), Value(-1)).second);
+        CHECK(object.size() == 1001);
+
+        const map<string, Value>& constObject = object;
+        CHECK(constObject[Key(999)].AsInt64() == 999);
+
+        // copy and move
+        map<string, Value> copy = object;
+        copy[Key(0)] = EJSON_TEXT("changed");
+        CHECK(object[Key(0)].AsInt64() == 0);
+        CHECK(copy.Find(Key(500))->AsInt64() == 500);
+        map<string, Value> moved = EJSON_MOVE(copy);
+        CHECK(moved.size() == 1001);
+        CHECK(moved.Find(EJSON_TEXT("new"))->AsInt64() == -1);
+        copy[EJSON_TEXT("again")] = 1;
+        CHECK(copy.size() == 1);
+        CHECK(copy.Find(EJSON_TEXT("again")) != nullptr);
+
+        // through Value
+        Value value;
+        REQUIRE(Read(EJSON_TEXT("{\"b\":1,\"a\":{\"d\":2,\"c\":[3]},\"e\":null}"), value));
+        string output;
+        Write(value, output);
+        CHECK(output == EJSON_TEXT("{\"b\":1,\"a\":{\"d\":2,\"c\":[3]},\"e\":null}"));
+        CHECK(((const Value&)value)[EJSON_TEXT("a")][EJSON_TEXT("c")][0].AsInt64() == 3);
+        CHECK(((const Value&)value)[EJSON_TEXT("z")].IsInvalid());
+    }
+
+    TEST_CASE("test_ordered_map_small")
+    {
+        // below, at and past the linear scan threshold
+        for (int count = 1; count <= EJSON_SMALL_OBJECT * 3; ++count)
+        {
+            map<string, Value> object;
+            string json = EJSON_TEXT("{");
+            for (int i = 0; i < count; ++i)
+            {
+                object[Key(i)] = i;
+                if (i != 0)
+                    json += EJSON_TEXT(",");
+                json += EJSON_TEXT("\"") + Key(i) + EJSON_TEXT("\":") + string(1, (string_char)(EJSON_TEXT('0') + i % 10));
+            }
+            json += EJSON_TEXT("}");
+            REQUIRE(object.size() == (size_t)count);
+            CHECK(object.Find(Key(count)) == nullptr);
+            CHECK(!object.emplace(Key(0), Value(-1)).second);
+
+            // keys shared by the reader
+            Value value;
+            REQUIRE(Read(json, value));
+            const map<string, Value>& read = value.AsObject();
+            REQUIRE(read.size() == (size_t)count);
+            for (int i = 0; i < count; ++i)
+            {
+                CHECK(object.Find(Key(i))->AsInt64() == i);
+                REQUIRE(read.Find(Key(i)) != nullptr);
+                CHECK(read.Find(Key(i))->AsInt64() == i % 10);
+            }
+            CHECK(read.Find(Key(count)) == nullptr);
+
+            string output;
+            Write(value, output);
+            CHECK(output == json);
+        }
+    }
+}
+#endif
+
+#if EJSON_VALUE_COMPACT
+namespace test_value_compact
+{
+    using namespace ejson;
+
+    TEST_CASE("test_value_compact")
+    {
+        CHECK(sizeof(Value) == 16);
+
+        Value value;
+        REQUIRE(Read(EJSON_TEXT("{\"id\":-12,\"big\":18446744073709551615,\"ratio\":0.5,\"name\":\"a long enough name\",\"tags\":[true,null,\"x\",[1,2]],\"child\":{\"a\":1}}"), value));
+        const Value& constValue = value;
+        CHECK(constValue[EJSON_TEXT("id")].AsInt64() == -12);
+        CHECK(constValue[EJSON_TEXT("big")].AsUInt64() == 18446744073709551615ull);
+        CHECK(constValue[EJSON_TEXT("ratio")].AsNumber() == 0.5);
+        CHECK(constValue[EJSON_TEXT("name")].AsStringView() == EJSON_TEXT("a long enough name"));
+        CHECK(constValue[EJSON_TEXT("tags")][3][1].AsInt64() == 2);
+        CHECK(constValue[EJSON_TEXT("child")][EJSON_TEXT("a")].AsInt64() == 1);
+
+        // copies are deep
+        Value copy = value;
+        copy[EJSON_TEXT("tags")][0] = false;
+        copy[EJSON_TEXT("name")].AsString() += EJSON_TEXT("!");
+        CHECK(constValue[EJSON_TEXT("tags")][0].AsBool());
+        CHECK(constValue[EJSON_TEXT("name")].AsStringView() == EJSON_TEXT("a long enough name"));
+
+        // moves take the box
+        const vector<Value>* tags = &value[EJSON_TEXT("tags")].AsArray();
+        Value moved(EJSON_MOVE(value[EJSON_TEXT("tags")]));
+        CHECK(&moved.AsArray() == tags);
+        CHECK(value[EJSON_TEXT("tags")].IsInvalid());
+        const string* name = &value[EJSON_TEXT("name")].AsString();
+        moved = EJSON_TEXT("short");
+        moved.Set(EJSON_MOVE(value[EJSON_TEXT("name")]));
+        CHECK(&moved.AsString() == name);
+
+        // a value moved out of its own content
+        Value nested;
+        nested[0][0] = EJSON_TEXT("inner value, long enough to be boxed");
+        nested.Set(EJSON_MOVE(nested[0]));
+        CHECK(nested[0].AsStringView() == EJSON_TEXT("inner value, long enough to be boxed"));
+
+        string output;
+        Write(copy, output);
+        CHECK(output == EJSON_TEXT("{\"id\":-12,\"big\":18446744073709551615,\"ratio\":0.5,\"name\":\"a long enough name!\",\"tags\":[false,null,\"x\",[1,2]],\"child\":{\"a\":1}}"));
+    }
+}
+#endif
+
 namespace test_code
 {
     using namespace ejson;
@@ -295,7 +2547,7 @@ namespace test_code
 
         string str;
         Write(json, str);
-        REQUIRE(str == EJSON_TEXT("{\"FirstName\":\"John\",\"LastName\":\"Doe\",\"Age\":71,\"Music\":[\"punk\",\"country\",\"folk\",0,null,true,false,1.2,1.2,[false],{\"p\":\"v\"}]}"));
+        REQUIRE(str == EJSON_TEXT("{\"FirstName\":\"John\",\"LastName\":\"Doe\",\"Age\":71,\"Music\":[\"punk\",\"country\",\"folk\",0,null,true,false,1.2000000476837158,1.2,[false],{\"p\":\"v\"}]}"));
     }
 }
 